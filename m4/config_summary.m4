@@ -29,6 +29,7 @@ echo Build host.................... : $BUILD_HOST
 echo Configure date................ : $BUILD_DATE
 echo Build architecture............ : $BUILD_ARCH
 echo Revision id................... : $BUILD_VERSION
+echo Fast math digits.............. : $fast_math_digits
 echo
 echo Testing Options:
 echo '  'Number of tuples............ : $n_tuples
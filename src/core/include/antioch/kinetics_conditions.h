@@ -34,7 +34,6 @@
 
 // C++
 #include <vector>
-#include <map>
 
 namespace Antioch{
 
@@ -54,10 +53,13 @@ namespace Antioch{
       belongs to this object, if there is any cleaning to do,
       it must be done elsewhere.
 
-      Might be interesting to see about the "double" case
-      for temperature: faster to copy instead of copying
-      the reference, and it's expected to be the classic
-      case.
+      The temperature is the exception: it is copied, so that
+      the conditions can be built from a temporary, and
+      update_temperature() lets one object be reused from
+      cell to cell, the particle fluxes being kept.
+
+      Particle fluxes are stored in a table indexed by the
+      reaction index, built by add_particle_flux().
    */
   template <typename StateType, 
             typename VectorStateType = std::vector<StateType> >
@@ -66,10 +68,21 @@ namespace Antioch{
         public:
 
           KineticsConditions(const StateType & temperature);
+          KineticsConditions(const KineticsConditions<StateType,VectorStateType> & other);
           ~KineticsConditions();
 
+          KineticsConditions<StateType,VectorStateType> & operator=(const KineticsConditions<StateType,VectorStateType> & other);
+
+          //! Sets the particle flux of reaction \p nr
+          /*!
+           * Only the first flux added for a reaction is kept, the
+           * later ones are ignored.
+           */
           void add_particle_flux(const ParticleFlux<VectorStateType> & pf, unsigned int nr);
 
+          //! Changes the temperature, and the temperature cache
+          void update_temperature(const StateType & temperature);
+
           const StateType & T() const;
 
           //! returns the temperature T,
@@ -79,16 +92,20 @@ namespace Antioch{
 
           const TempCache<StateType> & temp_cache() const;
 
+          //! Particle flux of reaction \p nr, an error if none was added
           const ParticleFlux<VectorStateType> & particle_flux(int nr) const;
 
         private:
 
           KineticsConditions();
 
+          StateType _T;
+
+          //! refers to _T
           TempCache<StateType> _temperature; 
 
-        // pointer's not const, particle flux is
-          std::map<unsigned int,ParticleFlux<VectorStateType> const * const > _map_pf; 
+        // particle flux of reaction nr, NULL if none
+          std::vector<ParticleFlux<VectorStateType> const *> _pf; 
 
   };
 
@@ -96,11 +113,37 @@ namespace Antioch{
   template <typename StateType, typename VectorStateType>
   inline
   KineticsConditions<StateType,VectorStateType>::KineticsConditions(const StateType & temperature):
-        _temperature(temperature)
+        _T(temperature),
+        _temperature(_T)
+  {
+    return;
+  }
+
+  template <typename StateType, typename VectorStateType>
+  inline
+  KineticsConditions<StateType,VectorStateType>::KineticsConditions(const KineticsConditions<StateType,VectorStateType> & other):
+        _T(other._T),
+        _temperature(_T,other._temperature.T2,other._temperature.T3,other._temperature.T4,other._temperature.lnT),
+        _pf(other._pf)
   {
     return;
   }
 
+  template <typename StateType, typename VectorStateType>
+  inline
+  KineticsConditions<StateType,VectorStateType> &
+  KineticsConditions<StateType,VectorStateType>::operator=(const KineticsConditions<StateType,VectorStateType> & other)
+  {
+     if(this == &other)
+       return *this;
+
+     _T = other._T;
+     _temperature = other._temperature;
+     _pf = other._pf;
+
+     return *this;
+  }
+
   template <typename StateType, typename VectorStateType>
   inline
   KineticsConditions<StateType,VectorStateType>::~KineticsConditions()
@@ -112,29 +155,43 @@ namespace Antioch{
   inline
   void KineticsConditions<StateType,VectorStateType>::add_particle_flux(const ParticleFlux<VectorStateType> & pf, unsigned int nr)
   {
-     _map_pf.insert(std::make_pair(nr, &pf));
+     if(nr >= _pf.size())
+       _pf.resize(nr + 1, NULL);
+
+     if(!_pf[nr])
+       _pf[nr] = &pf;
+  }
+
+  template <typename StateType, typename VectorStateType>
+  inline
+  void KineticsConditions<StateType,VectorStateType>::update_temperature(const StateType & temperature)
+  {
+     _T = temperature;
+     _temperature.update();
   }
 
   template <typename StateType, typename VectorStateType>
   inline
   const StateType & KineticsConditions<StateType,VectorStateType>::T() const
   {
-     return _temperature.T;
+     return _T;
   }
 
   template <typename StateType, typename VectorStateType>
   inline
   const StateType & KineticsConditions<StateType,VectorStateType>::Tvib() const
   {
-     return _temperature.T;
+     return _T;
   }
 
   template <typename StateType, typename VectorStateType>
   inline
   const ParticleFlux<VectorStateType> & KineticsConditions<StateType,VectorStateType>::particle_flux(int nr) const
   {
-     antioch_assert(_map_pf.count(nr));
-     return *(_map_pf.at(nr));
+     if(nr < 0 || static_cast<unsigned int>(nr) >= _pf.size() || !_pf[nr])
+       antioch_error_msg("No particle flux was added for reaction " << nr);
+
+     return *(_pf[nr]);
   }
 
   template <typename StateType, typename VectorStateType>
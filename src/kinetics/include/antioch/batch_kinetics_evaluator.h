@@ -0,0 +1,284 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_BATCH_KINETICS_EVALUATOR_H
+#define ANTIOCH_BATCH_KINETICS_EVALUATOR_H
+
+// Antioch
+#include "antioch/reaction_set.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/kinetics_workspace.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+  //! Class to handle computing mass source terms on many cells at once.
+  /*! Instead of one call per cell (or quadrature point), the state of
+   *  \c n_cells cells is given at once, stored species major with the
+   *  cells contiguous: the molar density of species s in cell c is
+   *  molar_densities[s*n_cells + c]. Temperatures are stored in an array of
+   *  size n_cells, and the sources are returned in the same layout as the
+   *  molar densities.
+   *
+   *  The loops over the reactions are the outer loops, the innermost loops
+   *  run over the cells so the parameters of each reaction are loaded once
+   *  per batch and the cell loops can be vectorized by the compiler.
+   *  Plain std::vector<CoeffType> are enough, no vector type is needed.
+   *
+   *  As for the KineticsEvaluator, the methods taking a KineticsWorkspace
+   *  are const and the evaluator can be shared between threads, the other
+   *  methods use a workspace owned by the evaluator. All the scratch of a
+   *  batch lives in the workspace: once it has seen a batch of n_cells
+   *  cells, a batch of at most n_cells cells allocates nothing.
+   *  The reaction set is compiled at construction (see CompiledReactionSet),
+   *  it must not be modified while this evaluator is in use.
+   */
+  template<typename CoeffType=double>
+  class BatchKineticsEvaluator
+  {
+  public:
+
+    BatchKineticsEvaluator( const ReactionSet<CoeffType>& reaction_set );
+
+    ~BatchKineticsEvaluator();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    unsigned int n_species() const;
+
+    unsigned int n_reactions() const;
+
+    //! Compute species molar production/destruction rates per unit volume, on \p n_cells cells
+    /*! \f$ \left(mole/sec/m^3\right)\f$ */
+    void compute_mole_sources( unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mole_sources );
+
+    //! Compute species production/destruction rates per unit volume, on \p n_cells cells
+    /*! \f$ \left(kg/sec/m^3\right)\f$ */
+    void compute_mass_sources( unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mass_sources );
+
+    //! Compute species molar production/destruction rates per unit volume, in \p workspace
+    void compute_mole_sources( KineticsWorkspace<CoeffType>& workspace,
+                               unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mole_sources ) const;
+
+    //! Compute species production/destruction rates per unit volume, in \p workspace
+    void compute_mass_sources( KineticsWorkspace<CoeffType>& workspace,
+                               unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mass_sources ) const;
+
+    //! Compute species molar production/destruction rates per unit volume, on the cells \p begin to \p end
+    /*!
+     * All the arrays hold the \p n_cells cells, only the sources of the
+     * range are written. Threads can evaluate disjoint ranges of the same
+     * batch in place, each with its own \p workspace.
+     */
+    void compute_mole_sources( KineticsWorkspace<CoeffType>& workspace,
+                               unsigned int n_cells,
+                               unsigned int begin, unsigned int end,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mole_sources ) const;
+
+    //! Compute species production/destruction rates per unit volume, on the cells \p begin to \p end
+    void compute_mass_sources( KineticsWorkspace<CoeffType>& workspace,
+                               unsigned int n_cells,
+                               unsigned int begin, unsigned int end,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mass_sources ) const;
+
+  protected:
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    CompiledReactionSet<CoeffType> _compiled;
+
+    //! used by the methods without an explicit workspace
+    KineticsWorkspace<CoeffType> _workspace;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  BatchKineticsEvaluator<CoeffType>::BatchKineticsEvaluator( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set( reaction_set ),
+      _compiled( reaction_set ),
+      _workspace( reaction_set, 0 )
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  BatchKineticsEvaluator<CoeffType>::~BatchKineticsEvaluator()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  const ReactionSet<CoeffType>& BatchKineticsEvaluator<CoeffType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int BatchKineticsEvaluator<CoeffType>::n_species() const
+  {
+    return _compiled.n_species();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int BatchKineticsEvaluator<CoeffType>::n_reactions() const
+  {
+    return _compiled.n_reactions();
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mole_sources( unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mole_sources )
+  {
+    this->compute_mole_sources( _workspace, n_cells, T, molar_densities, h_RT_minus_s_R, mole_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mole_sources( KineticsWorkspace<CoeffType>& workspace,
+                                                                unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mole_sources ) const
+  {
+    this->compute_mole_sources( workspace, n_cells, 0, n_cells, T, molar_densities, h_RT_minus_s_R, mole_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mole_sources( KineticsWorkspace<CoeffType>& workspace,
+                                                                unsigned int n_cells,
+                                                                unsigned int begin, unsigned int end,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mole_sources ) const
+  {
+    antioch_assert_less_equal( begin, end );
+    antioch_assert_less_equal( end, n_cells );
+    antioch_assert_equal_to( T.size(), n_cells );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() * n_cells );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() * n_cells );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() * n_cells );
+
+    // rates of progress of the range, reaction major, cells contiguous
+    // the capacity is kept from one batch to the next
+    std::vector<CoeffType>& net_reaction_rates = workspace.net_reaction_rates();
+    net_reaction_rates.resize( this->n_reactions() * (end - begin) );
+
+    _compiled.compute_batch_reaction_rates( workspace, n_cells, begin, end, T, molar_densities, h_RT_minus_s_R, net_reaction_rates );
+
+    _reaction_set.stoichiometric_matrix().multiply_cells( n_cells, begin, end, net_reaction_rates, mole_sources );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mass_sources( unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mass_sources )
+  {
+    this->compute_mass_sources( _workspace, n_cells, T, molar_densities, h_RT_minus_s_R, mass_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mass_sources( KineticsWorkspace<CoeffType>& workspace,
+                                                                unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mass_sources ) const
+  {
+    this->compute_mass_sources( workspace, n_cells, 0, n_cells, T, molar_densities, h_RT_minus_s_R, mass_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void BatchKineticsEvaluator<CoeffType>::compute_mass_sources( KineticsWorkspace<CoeffType>& workspace,
+                                                                unsigned int n_cells,
+                                                                unsigned int begin, unsigned int end,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mass_sources ) const
+  {
+    // Quantities asserted in compute_mole_sources call
+    this->compute_mole_sources( workspace, n_cells, begin, end, T, molar_densities, h_RT_minus_s_R, mass_sources );
+
+    const ChemicalMixture<CoeffType>& chem_mixture = _reaction_set.chemical_mixture();
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        const CoeffType M = chem_mixture.M(s);
+        for (unsigned int c=begin; c < end; c++)
+          {
+            mass_sources[s * n_cells + c] *= M;
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_BATCH_KINETICS_EVALUATOR_H
@@ -0,0 +1,2177 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_COMPILED_REACTION_SET_H
+#define ANTIOCH_COMPILED_REACTION_SET_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming_decl.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_workspace.h"
+#include "antioch/reaction_set.h"
+#include "antioch/rate_coefficient_cache.h"
+#include "antioch/constant_rate.h"
+#include "antioch/hercourtessen_rate.h"
+#include "antioch/berthelot_rate.h"
+#include "antioch/arrhenius_rate.h"
+#include "antioch/berthelothercourtessen_rate.h"
+#include "antioch/kooij_rate.h"
+#include "antioch/vanthoff_rate.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Antioch
+{
+
+  /*!
+   * Flat, read-only view of a ReactionSet.
+   *
+   * compile() walks the reactions once and stores everything the rate
+   * evaluation needs in contiguous arrays: the rate constants
+   * parameters, reactant and product ids, stoichiometric coefficients
+   * and partial orders, and the third-body efficiencies. All the
+   * non-photochemical kinetics models are special cases of the Van't Hoff
+   * equation
+   * \f[
+   *    k(T) = C_f \exp\left(\eta \ln(T) - \frac{E_a}{T} + D T\right)
+   * \f]
+   * so they are all evaluated by the same loop, without the
+   * \c switch on the reaction type nor the kinetics model. Reactions
+   * are then corrected by type in separate loops (three-body, Lindemann
+   * and Troe falloffs).
+   *
+   * The partial orders are classified once by compile(): integer orders
+   * are evaluated as products of the concentrations, fractional orders
+   * as \f$\exp\left(\sum_s \nu_s \ln c_s\right)\f$, with \f$\ln c_s\f$
+   * computed once per evaluation for the species that need it.
+   *
+   * Reactions using a photochemical rate constant depend on the
+   * KineticsConditions particle fluxes and are still evaluated through
+   * the ReactionSet.
+   *
+   * The ReactionSet is not copied: any modification of the reaction set
+   * (added or removed reaction, new parameter value) requires a call to
+   * compile() before the next evaluation.
+   */
+  template<typename CoeffType=double>
+  class CompiledReactionSet
+  {
+  public:
+
+    //! Constructor, compiles the reaction set.
+    CompiledReactionSet( const ReactionSet<CoeffType>& reaction_set );
+
+    ~CompiledReactionSet();
+
+    //! (Re)builds the flat arrays from the reaction set.
+    /*!
+     * The evaluations check ReactionSet::parameter_version(), and error
+     * out if the reaction set was modified since the last compile().
+     */
+    void compile();
+
+    //! \returns the number of species.
+    unsigned int n_species() const;
+
+    //! \returns the number of reactions.
+    unsigned int n_reactions() const;
+
+    //! \returns the compiled reaction set.
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    //! Compute the rates of progress for each reaction
+    /*!
+     * Same interface and results as ReactionSet::compute_reaction_rates().
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction, reusing the temperature-only quantities of \p cache
+    /*!
+     * \p cache is refilled if its temperature differs from the one of
+     * \p conditions, see RateCoefficientCache.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( RateCoefficientCache<StateType>& cache,
+                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction, with the work arrays of \p workspace
+    /*!
+     * Allocates nothing once \p workspace and \p cache hold arrays of the
+     * right size.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( KineticsWorkspace<StateType>& workspace,
+                                 RateCoefficientCache<StateType>& cache,
+                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction, on \p n_cells cells
+    /*!
+     * All the arrays are stored species (or reaction) major, cells
+     * contiguous: the molar density of species s in cell c is
+     * molar_densities[s*n_cells + c], the rate of progress of reaction
+     * r in cell c is net_reaction_rates[r*n_cells + c].
+     * \p T is of size n_cells.
+     *
+     * The innermost loops run over the cells, the parameters of a
+     * reaction are loaded once for all the cells.
+     * The rate constants are evaluated in log space, as the product of
+     * the n_rate_constants x 4 matrix of log_rate_coefficients() by the
+     * 4 x n_cells matrix of the temperature basis \f$[1, \ln T, 1/T, T]\f$,
+     * followed by one exponential per rate constant and cell.
+     * Photochemical reactions are not supported.
+     */
+    void compute_batch_reaction_rates( unsigned int n_cells,
+                                       const std::vector<CoeffType>& T,
+                                       const std::vector<CoeffType>& molar_densities,
+                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                       std::vector<CoeffType>& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction, on \p n_cells cells, with the work arrays of \p workspace
+    /*!
+     * Allocates nothing once \p workspace holds arrays for \p n_cells cells.
+     */
+    void compute_batch_reaction_rates( KineticsWorkspace<CoeffType>& workspace,
+                                       unsigned int n_cells,
+                                       const std::vector<CoeffType>& T,
+                                       const std::vector<CoeffType>& molar_densities,
+                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                       std::vector<CoeffType>& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction, on the cells \p begin to \p end of \p n_cells cells
+    /*!
+     * The state arrays hold the \p n_cells cells, \p net_reaction_rates
+     * only the m = end - begin cells of the range: the rate of progress
+     * of reaction r in cell begin + c is net_reaction_rates[r*m + c].
+     * Several threads can evaluate disjoint ranges of the same batch,
+     * each with its own \p workspace.
+     */
+    void compute_batch_reaction_rates( KineticsWorkspace<CoeffType>& workspace,
+                                       unsigned int n_cells,
+                                       unsigned int begin, unsigned int end,
+                                       const std::vector<CoeffType>& T,
+                                       const std::vector<CoeffType>& molar_densities,
+                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                       std::vector<CoeffType>& net_reaction_rates ) const;
+
+    //! Compute the rates of progress and derivatives for each reaction
+    /*!
+     * Same interface and results as ReactionSet::compute_reaction_rates_and_derivs().
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+    void compute_reaction_rates_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            const VectorStateType& molar_densities,
+                                            const VectorStateType& h_RT_minus_s_R,
+                                            const VectorStateType& dh_RT_minus_s_R_dT,
+                                            VectorReactionsType& net_reaction_rates,
+                                            VectorReactionsType& dnet_rate_dT,
+                                            MatrixReactionsType& dnet_rate_dX_s ) const;
+
+    //! Compute the rates of progress and derivatives for each reaction, with the work arrays of \p workspace
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+    void compute_reaction_rates_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                            RateCoefficientCache<StateType>& cache,
+                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            const VectorStateType& molar_densities,
+                                            const VectorStateType& h_RT_minus_s_R,
+                                            const VectorStateType& dh_RT_minus_s_R_dT,
+                                            VectorReactionsType& net_reaction_rates,
+                                            VectorReactionsType& dnet_rate_dT,
+                                            MatrixReactionsType& dnet_rate_dX_s ) const;
+
+    //! Number of rate constants, including the high pressure limits of the falloffs
+    unsigned int n_rate_constants() const;
+
+    //! Rate constants in log space, row major n_rate_constants() x 4 matrix
+    /*!
+     * \f$\ln |k| = \ln |C_f| + \eta \ln T - E_a/T + D T\f$: the row of a
+     * rate constant is \f$[\ln |C_f|, \eta, -E_a, D]\f$, its sign is given by
+     * log_rate_signs(). The rate constants of the reactions come first, in
+     * the reactions order, then the high pressure limits of the Lindemann
+     * falloffs and of the Troe falloffs.
+     */
+    const std::vector<CoeffType>& log_rate_coefficients() const;
+
+    //! Sign of the preexponential factor of each rate constant
+    const std::vector<CoeffType>& log_rate_signs() const;
+
+    //! Total number of species the rates of progress depend on
+    unsigned int n_dependencies() const;
+
+    //! Rate of progress \p r depends on the species dependency_ids()[i]
+    //! for i from dependency_offsets()[r] to dependency_offsets()[r+1]
+    const std::vector<unsigned int>& dependency_offsets() const;
+
+    //! Species each rate of progress depends on, sorted by reaction then species
+    const std::vector<unsigned int>& dependency_ids() const;
+
+    //! Compute the rates of progress and their sparse derivatives
+    /*!
+     * The molar densities derivatives are only computed for the species the
+     * reactions depend on (reactants, products of reversible reactions, and
+     * third bodies): \p dnet_rate_dX is of size n_dependencies(), the value
+     * of index i is the derivative of the rate of progress r with respect to
+     * the molar density of species dependency_ids()[i], with i between
+     * dependency_offsets()[r] and dependency_offsets()[r+1].
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+    void compute_reaction_rates_and_sparse_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const VectorStateType& molar_densities,
+                                                   const VectorStateType& h_RT_minus_s_R,
+                                                   const VectorStateType& dh_RT_minus_s_R_dT,
+                                                   VectorReactionsType& net_reaction_rates,
+                                                   VectorReactionsType& dnet_rate_dT,
+                                                   VectorDependenciesType& dnet_rate_dX ) const;
+
+    //! Compute the rates of progress and their sparse derivatives, reusing the temperature-only quantities of \p cache
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+    void compute_reaction_rates_and_sparse_derivs( RateCoefficientCache<StateType>& cache,
+                                                   const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const VectorStateType& molar_densities,
+                                                   const VectorStateType& h_RT_minus_s_R,
+                                                   const VectorStateType& dh_RT_minus_s_R_dT,
+                                                   VectorReactionsType& net_reaction_rates,
+                                                   VectorReactionsType& dnet_rate_dT,
+                                                   VectorDependenciesType& dnet_rate_dX ) const;
+
+    //! Compute the rates of progress and their sparse derivatives, with the work arrays of \p workspace
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+    void compute_reaction_rates_and_sparse_derivs( KineticsWorkspace<StateType>& workspace,
+                                                   RateCoefficientCache<StateType>& cache,
+                                                   const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const VectorStateType& molar_densities,
+                                                   const VectorStateType& h_RT_minus_s_R,
+                                                   const VectorStateType& dh_RT_minus_s_R_dT,
+                                                   VectorReactionsType& net_reaction_rates,
+                                                   VectorReactionsType& dnet_rate_dT,
+                                                   VectorDependenciesType& dnet_rate_dX ) const;
+
+    //! ReactionSet::parameter_version() at the last compile()
+    unsigned int compiled_version() const;
+
+    //! Fills \p cache at the temperature of \p conditions, unless it already holds it
+    /*!
+     * The derivatives are computed if \p dh_RT_minus_s_R_dT is not NULL.
+     * Used by the evaluations taking a cache, or to fill a cache beforehand.
+     */
+    template <typename StateType, typename VectorStateType>
+    void update_rate_coefficient_cache( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                        const VectorStateType& h_RT_minus_s_R,
+                                        const VectorStateType* dh_RT_minus_s_R_dT,
+                                        RateCoefficientCache<StateType>& cache ) const;
+
+    //! Van't Hoff parameters of an analytical rate constant
+    /*!
+     * \returns false if the kinetics model has no analytical expression
+     * (photochemical rate).
+     */
+    static bool rate_parameters( const KineticsType<CoeffType>& rate,
+                                 CoeffType& Cf, CoeffType& eta, CoeffType& Ea, CoeffType& D );
+
+  private:
+
+    CompiledReactionSet();
+
+    //! Work arrays of the evaluations in a KineticsWorkspace
+    enum WorkArray{ KFWD = 0,
+                    DKFWD_DT,
+                    DKFWD_DM,
+                    MIXTURES,
+                    LOG_DENSITIES,
+                    VALUES,
+                    DVALUES,
+                    DNET_RATE_DX,
+                    DNET_RATE_DX_S,
+                    BATCH_BASIS,
+                    BATCH_RATE_CONSTANTS,
+                    BATCH_M_TOTAL,
+                    BATCH_KEQ,
+                    BATCH_LOG_P0_RT,
+                    BATCH_FWD,
+                    BATCH_BKWD,
+                    BATCH_WORK };
+
+    //! Falloff reactions sharing the same falloff model
+    /*!
+     * The low pressure limit is stored with the other rate constants,
+     * only the high pressure limit is kept here.
+     */
+    template <typename FalloffType>
+    struct FalloffGroup
+    {
+      void clear();
+
+      std::vector<unsigned int> reactions;
+      std::vector<unsigned int> mixtures;
+      std::vector<CoeffType>    kinf_Cf;
+      std::vector<CoeffType>    kinf_eta;
+      std::vector<CoeffType>    kinf_Ea;
+      std::vector<CoeffType>    kinf_D;
+      std::vector<FalloffType>  falloff;
+    };
+
+    //! Stores a rate constant in the reaction rate slots
+    void add_rate_constant( const KineticsType<CoeffType>& rate );
+
+    //! Stores the efficiencies of reaction \p r, or ones, as a mixture
+    /*!
+     * Only the non-unit efficiencies are stored, as corrections
+     * to the total concentration. Reactions with the same corrections
+     * share their mixture.
+     */
+    unsigned int add_mixture( const Reaction<CoeffType>& reaction, bool use_efficiencies );
+
+    //! Species each reaction depends on
+    void build_dependencies();
+
+    //! \returns \p order if it is a non-negative integer, fractional_order() otherwise
+    static int integer_order( const CoeffType& order );
+
+    //! Marker of a fractional order in the integer orders
+    static int fractional_order();
+
+    //! \f$c^n\f$ by multiplications
+    template <typename StateType>
+    static StateType integer_power( const StateType& c, int n );
+
+    //! \f$\ln c_s\f$ of the species with a fractional order, untouched otherwise
+    template <typename StateType, typename VectorStateType>
+    void compute_log_densities( const VectorStateType& molar_densities,
+                                std::vector<StateType>& log_densities ) const;
+
+    //! \f$\prod_s c_s^{\nu_s}\f$ over the entries \p begin to \p end of \p ids
+    template <typename StateType, typename VectorStateType>
+    StateType concentrations_product( unsigned int begin, unsigned int end,
+                                      const std::vector<unsigned int>& ids,
+                                      const std::vector<CoeffType>& orders,
+                                      const std::vector<int>& integer_orders,
+                                      const VectorStateType& molar_densities,
+                                      const std::vector<StateType>& log_densities ) const;
+
+    //! Multiplies \p product by \f$\prod_s c_s^{\nu_s}\f$ in each of the \p n_cells cells
+    /*!
+     * The \p n_cells concentrations of species s start at
+     * molar_densities[s*stride]. \p work is n_cells long, \p log_X holds
+     * \f$\ln c_s\f$ of the species with a fractional order, n_cells
+     * per species.
+     */
+    void multiply_batch_concentrations( unsigned int n_cells,
+                                        unsigned int begin, unsigned int end,
+                                        const std::vector<unsigned int>& ids,
+                                        const std::vector<CoeffType>& orders,
+                                        const std::vector<int>& integer_orders,
+                                        const CoeffType * molar_densities,
+                                        unsigned int stride,
+                                        const std::vector<CoeffType>& log_X,
+                                        std::vector<CoeffType>& work,
+                                        std::vector<CoeffType>& product ) const;
+
+    //! \f$c^\nu\f$ and \f$\nu c^{\nu-1}\f$
+    template <typename StateType>
+    static void power_and_derivative( const StateType& c, const StateType& log_c,
+                                      const CoeffType& order, int integer_order,
+                                      StateType& value, StateType& derivative );
+
+    template <typename FalloffType>
+    void add_falloff( const Reaction<CoeffType>& reaction, unsigned int rxn,
+                      unsigned int mixture, const FalloffType& falloff,
+                      FalloffGroup<FalloffType>& group );
+
+    //! \returns \f$[M]\f$ of every mixture
+    template <typename StateType, typename VectorStateType>
+    void compute_mixtures( const VectorStateType& molar_densities,
+                           std::vector<StateType>& M ) const;
+
+    //! Forward rate coefficients of the compiled reactions
+    //! \p M is the work array of the mixtures
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_forward_rate_coefficients( const RateCoefficientCache<StateType>& cache,
+                                            const VectorStateType& molar_densities,
+                                            std::vector<StateType>& M,
+                                            VectorReactionsType& kfwd ) const;
+
+    //! Forward rate coefficients of the compiled reactions and derivatives
+    /*!
+     * The forward rate coefficients depend on the concentrations only
+     * through the mixture \f$[M]\f$, thus \f$\frac{\partial k}{\partial c_i}
+     * = \epsilon_i \frac{\partial k}{\partial [M]}\f$.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficients_and_derivatives( const RateCoefficientCache<StateType>& cache,
+                                                            const VectorStateType& molar_densities,
+                                                            std::vector<StateType>& M,
+                                                            std::vector<StateType>& kfwd,
+                                                            std::vector<StateType>& dkfwd_dT,
+                                                            std::vector<StateType>& dkfwd_dM ) const;
+
+    //! \p kinf_offset is the position of the group high pressure limits in the cache
+    template <typename StateType, typename FalloffType, typename VectorReactionsType>
+    void apply_falloff( const RateCoefficientCache<StateType>& cache,
+                        const std::vector<StateType>& M,
+                        const FalloffGroup<FalloffType>& group,
+                        unsigned int kinf_offset,
+                        VectorReactionsType& kfwd ) const;
+
+    //! Falloff function \f$F\f$ of the falloff \p i of its group
+    template <typename StateType>
+    static StateType falloff_value( const LindemannFalloff<CoeffType>& falloff, unsigned int i,
+                                    const RateCoefficientCache<StateType>& cache,
+                                    const StateType& M, const StateType& k0, const StateType& kinf );
+
+    template <typename StateType>
+    static StateType falloff_value( const TroeFalloff<CoeffType>& falloff, unsigned int i,
+                                    const RateCoefficientCache<StateType>& cache,
+                                    const StateType& M, const StateType& k0, const StateType& kinf );
+
+    //! Falloff function \f$F\f$ of the falloff \p i of its group, and its derivatives
+    template <typename StateType>
+    static void falloff_and_derivatives( const LindemannFalloff<CoeffType>& falloff, unsigned int i,
+                                         const RateCoefficientCache<StateType>& cache,
+                                         const StateType& M, const StateType& k0, const StateType& dk0_dT,
+                                         const StateType& kinf, const StateType& dkinf_dT,
+                                         StateType& F, StateType& dF_dT, StateType& dF_dM );
+
+    template <typename StateType>
+    static void falloff_and_derivatives( const TroeFalloff<CoeffType>& falloff, unsigned int i,
+                                         const RateCoefficientCache<StateType>& cache,
+                                         const StateType& M, const StateType& k0, const StateType& dk0_dT,
+                                         const StateType& kinf, const StateType& dkinf_dT,
+                                         StateType& F, StateType& dF_dT, StateType& dF_dM );
+
+    //! Fills the log space rate constants matrix
+    void build_log_rate_coefficients();
+
+    //! log_k = log_rate_coefficients() * basis, basis is 4 x n_cells
+    void compute_log_rate_constants( unsigned int n_cells,
+                                     const std::vector<CoeffType>& basis,
+                                     std::vector<CoeffType>& log_k ) const;
+
+    //! \p kinf are the high pressure limits of the group, n_cells per reaction
+    template <typename FalloffType>
+    void apply_batch_falloff( unsigned int n_cells,
+                              const CoeffType * T,
+                              const CoeffType * kinf,
+                              const std::vector<CoeffType>& M,
+                              const FalloffGroup<FalloffType>& group,
+                              std::vector<CoeffType>& kfwd ) const;
+
+    template <typename StateType, typename FalloffType>
+    void apply_falloff_and_derivatives( const RateCoefficientCache<StateType>& cache,
+                                        const std::vector<StateType>& M,
+                                        const FalloffGroup<FalloffType>& group,
+                                        unsigned int kinf_offset,
+                                        std::vector<StateType>& kfwd,
+                                        std::vector<StateType>& dkfwd_dT,
+                                        std::vector<StateType>& dkfwd_dM ) const;
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    unsigned int _n_species;
+
+    unsigned int _n_reactions;
+
+    //! rate constants, _rate_offsets[r] to _rate_offsets[r+1] for reaction r
+    std::vector<unsigned int> _rate_offsets;
+    std::vector<CoeffType>    _rate_Cf;
+    std::vector<CoeffType>    _rate_eta;
+    std::vector<CoeffType>    _rate_Ea;
+    std::vector<CoeffType>    _rate_D;
+
+    //! all the rate constants in log space, see log_rate_coefficients()
+    std::vector<CoeffType>    _log_rate_coefficients;
+    std::vector<CoeffType>    _log_rate_signs;
+
+    //! reactants, _reactant_offsets[r] to _reactant_offsets[r+1] for reaction r
+    std::vector<unsigned int> _reactant_offsets;
+    std::vector<unsigned int> _reactant_ids;
+    std::vector<CoeffType>    _reactant_orders;
+    //! see integer_order()
+    std::vector<int>          _reactant_integer_orders;
+
+    //! products, _product_offsets[r] to _product_offsets[r+1] for reaction r
+    std::vector<unsigned int> _product_offsets;
+    std::vector<unsigned int> _product_ids;
+    std::vector<CoeffType>    _product_orders;
+    std::vector<int>          _product_integer_orders;
+
+    //! species with a fractional order in at least one reaction
+    std::vector<unsigned int> _log_species;
+
+    std::vector<bool>         _reversible;
+    std::vector<CoeffType>    _max_rate;
+
+    //! third-body efficiencies minus one, non-zero only,
+    //! _mixture_offsets[m] to _mixture_offsets[m+1] for mixture m
+    std::vector<unsigned int> _mixture_offsets;
+    std::vector<unsigned int> _mixture_ids;
+    std::vector<CoeffType>    _mixture_corrections;
+    //! mixture of each reaction, n_mixtures() if none
+    std::vector<unsigned int> _reaction_mixture;
+    unsigned int              _n_mixtures;
+
+    //! three-body reactions and their mixture
+    std::vector<unsigned int> _three_body_reactions;
+    std::vector<unsigned int> _three_body_mixtures;
+
+    FalloffGroup<LindemannFalloff<CoeffType> > _lindemann;
+    FalloffGroup<TroeFalloff<CoeffType> >      _troe;
+
+    //! reactions left to the ReactionSet
+    std::vector<unsigned int> _photochemical_reactions;
+
+    //! species the rates of progress depend on, CSR
+    std::vector<unsigned int> _dependency_offsets;
+    std::vector<unsigned int> _dependency_ids;
+    //! efficiency of each dependency in the reaction mixture, zero if none
+    std::vector<CoeffType>    _dependency_efficiencies;
+    //! dependency index of each reactant and product
+    std::vector<unsigned int> _reactant_dependencies;
+    std::vector<unsigned int> _product_dependencies;
+
+    unsigned int _compiled_version;
+
+    const CoeffType _P0_R;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  CompiledReactionSet<CoeffType>::CompiledReactionSet( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set(reaction_set),
+      _n_species(0),
+      _n_reactions(0),
+      _n_mixtures(0),
+      _compiled_version(0),
+      _P0_R(1.0e5/Constants::R_universal<CoeffType>()) //SI
+  {
+    this->compile();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::compiled_version() const
+  {
+    return _compiled_version;
+  }
+
+  template<typename CoeffType>
+  inline
+  CompiledReactionSet<CoeffType>::~CompiledReactionSet()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_species() const
+  {
+    return _n_species;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_reactions() const
+  {
+    return _n_reactions;
+  }
+
+  template<typename CoeffType>
+  inline
+  const ReactionSet<CoeffType>& CompiledReactionSet<CoeffType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_rate_constants() const
+  {
+    return _log_rate_signs.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& CompiledReactionSet<CoeffType>::log_rate_coefficients() const
+  {
+    return _log_rate_coefficients;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& CompiledReactionSet<CoeffType>::log_rate_signs() const
+  {
+    return _log_rate_signs;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_dependencies() const
+  {
+    return _dependency_ids.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& CompiledReactionSet<CoeffType>::dependency_offsets() const
+  {
+    return _dependency_offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& CompiledReactionSet<CoeffType>::dependency_ids() const
+  {
+    return _dependency_ids;
+  }
+
+  template<typename CoeffType>
+  template<typename FalloffType>
+  inline
+  void CompiledReactionSet<CoeffType>::FalloffGroup<FalloffType>::clear()
+  {
+    reactions.clear();
+    mixtures.clear();
+    kinf_Cf.clear();
+    kinf_eta.clear();
+    kinf_Ea.clear();
+    kinf_D.clear();
+    falloff.clear();
+  }
+
+  template<typename CoeffType>
+  inline
+  bool CompiledReactionSet<CoeffType>::rate_parameters( const KineticsType<CoeffType>& rate,
+                                                        CoeffType& Cf, CoeffType& eta, CoeffType& Ea, CoeffType& D )
+  {
+    Cf  = 0;
+    eta = 0;
+    Ea  = 0;
+    D   = 0;
+
+    switch(rate.type())
+      {
+      case(KineticsModel::CONSTANT):
+        {
+          Cf  = static_cast<const ConstantRate<CoeffType>&>(rate).Cf();
+        }
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          const HercourtEssenRate<CoeffType>& he = static_cast<const HercourtEssenRate<CoeffType>&>(rate);
+          Cf  = he.Cf();
+          eta = he.eta();
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          const BerthelotRate<CoeffType>& be = static_cast<const BerthelotRate<CoeffType>&>(rate);
+          Cf  = be.Cf();
+          D   = be.D();
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          const ArrheniusRate<CoeffType>& ar = static_cast<const ArrheniusRate<CoeffType>&>(rate);
+          Cf  = ar.Cf();
+          Ea  = ar.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          const BerthelotHercourtEssenRate<CoeffType>& bhe = static_cast<const BerthelotHercourtEssenRate<CoeffType>&>(rate);
+          Cf  = bhe.Cf();
+          eta = bhe.eta();
+          D   = bhe.D();
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          const KooijRate<CoeffType>& ko = static_cast<const KooijRate<CoeffType>&>(rate);
+          Cf  = ko.Cf();
+          eta = ko.eta();
+          Ea  = ko.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          const VantHoffRate<CoeffType>& vh = static_cast<const VantHoffRate<CoeffType>&>(rate);
+          Cf  = vh.Cf();
+          eta = vh.eta();
+          Ea  = vh.Ea_K();
+          D   = vh.D();
+        }
+        break;
+
+      default:
+        {
+          return false;
+        }
+      } // switch(rate.type())
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::add_rate_constant( const KineticsType<CoeffType>& rate )
+  {
+    CoeffType Cf, eta, Ea, D;
+    bool analytical = rate_parameters(rate, Cf, eta, Ea, D);
+    antioch_assert(analytical);
+    (void)analytical;
+
+    _rate_Cf.push_back(Cf);
+    _rate_eta.push_back(eta);
+    _rate_Ea.push_back(Ea);
+    _rate_D.push_back(D);
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::add_mixture( const Reaction<CoeffType>& reaction, bool use_efficiencies )
+  {
+    const unsigned int begin = _mixture_ids.size();
+    if(use_efficiencies)
+      {
+        for(unsigned int s = 0; s < _n_species; s++)
+          {
+            if(reaction.efficiency(s) != CoeffType(1))
+              {
+                _mixture_ids.push_back(s);
+                _mixture_corrections.push_back(reaction.efficiency(s) - CoeffType(1));
+              }
+          }
+      }
+    const unsigned int size = _mixture_ids.size() - begin;
+
+    // same corrections as a previous mixture
+    for(unsigned int m = 0; m < _n_mixtures; m++)
+      {
+        if(_mixture_offsets[m+1] - _mixture_offsets[m] != size)
+          continue;
+
+        if(std::equal(_mixture_ids.begin() + begin, _mixture_ids.end(), _mixture_ids.begin() + _mixture_offsets[m]) &&
+           std::equal(_mixture_corrections.begin() + begin, _mixture_corrections.end(), _mixture_corrections.begin() + _mixture_offsets[m]))
+          {
+            _mixture_ids.resize(begin);
+            _mixture_corrections.resize(begin);
+            return m;
+          }
+      }
+
+    _mixture_offsets.push_back(_mixture_ids.size());
+
+    return _n_mixtures++;
+  }
+
+  template<typename CoeffType>
+  template<typename FalloffType>
+  inline
+  void CompiledReactionSet<CoeffType>::add_falloff( const Reaction<CoeffType>& reaction, unsigned int rxn,
+                                                    unsigned int mixture, const FalloffType& falloff,
+                                                    FalloffGroup<FalloffType>& group )
+  {
+    // low pressure limit is the reaction first rate constant,
+    // high pressure limit the second one
+    antioch_assert_equal_to(reaction.n_rate_constants(), 2);
+    this->add_rate_constant(reaction.forward_rate(0));
+
+    CoeffType Cf, eta, Ea, D;
+    bool analytical = rate_parameters(reaction.forward_rate(1), Cf, eta, Ea, D);
+    antioch_assert(analytical);
+    (void)analytical;
+
+    group.reactions.push_back(rxn);
+    group.mixtures.push_back(mixture);
+    group.kinf_Cf.push_back(Cf);
+    group.kinf_eta.push_back(eta);
+    group.kinf_Ea.push_back(Ea);
+    group.kinf_D.push_back(D);
+    group.falloff.push_back(falloff);
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compile()
+  {
+    _compiled_version = _reaction_set.parameter_version();
+
+    _n_species   = _reaction_set.n_species();
+    _n_reactions = _reaction_set.n_reactions();
+
+    _rate_offsets.assign(1,0);
+    _rate_Cf.clear();
+    _rate_eta.clear();
+    _rate_Ea.clear();
+    _rate_D.clear();
+
+    _reactant_offsets.assign(1,0);
+    _reactant_ids.clear();
+    _reactant_orders.clear();
+    _reactant_integer_orders.clear();
+
+    _product_offsets.assign(1,0);
+    _product_ids.clear();
+    _product_orders.clear();
+    _product_integer_orders.clear();
+    _log_species.clear();
+
+    _reversible.resize(_n_reactions);
+    _max_rate.resize(_n_reactions);
+
+    _mixture_offsets.assign(1,0);
+    _mixture_ids.clear();
+    _mixture_corrections.clear();
+    _n_mixtures = 0;
+    std::vector<unsigned int> reaction_mixture(_n_reactions, std::numeric_limits<unsigned int>::max());
+
+    _three_body_reactions.clear();
+    _three_body_mixtures.clear();
+    _lindemann.clear();
+    _troe.clear();
+    _photochemical_reactions.clear();
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+        for(unsigned int r = 0; r < reaction.n_reactants(); r++)
+          {
+            _reactant_ids.push_back(reaction.reactant_id(r));
+            _reactant_orders.push_back(reaction.reactant_partial_order(r));
+            _reactant_integer_orders.push_back(integer_order(_reactant_orders.back()));
+            if(_reactant_integer_orders.back() == fractional_order())
+              _log_species.push_back(reaction.reactant_id(r));
+          }
+        _reactant_offsets.push_back(_reactant_ids.size());
+
+        for(unsigned int p = 0; p < reaction.n_products(); p++)
+          {
+            _product_ids.push_back(reaction.product_id(p));
+            _product_orders.push_back(reaction.product_partial_order(p));
+            _product_integer_orders.push_back(integer_order(_product_orders.back()));
+            if(_product_integer_orders.back() == fractional_order())
+              _log_species.push_back(reaction.product_id(p));
+          }
+        _product_offsets.push_back(_product_ids.size());
+
+        _reversible[rxn] = reaction.reversible();
+        _max_rate[rxn]   = reaction.maximum_rate();
+
+        bool analytical = true;
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          {
+            analytical = analytical && (reaction.forward_rate(ir).type() != KineticsModel::PHOTOCHEM);
+          }
+
+        if(!analytical)
+          {
+            _photochemical_reactions.push_back(rxn);
+            _rate_offsets.push_back(_rate_Cf.size());
+            continue;
+          }
+
+        switch(reaction.type())
+          {
+          case(ReactionType::ELEMENTARY):
+          case(ReactionType::DUPLICATE):
+            {
+              for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+                {
+                  this->add_rate_constant(reaction.forward_rate(ir));
+                }
+            }
+            break;
+
+          case(ReactionType::THREE_BODY):
+            {
+              this->add_rate_constant(reaction.forward_rate(0));
+              reaction_mixture[rxn] = this->add_mixture(reaction,true);
+              _three_body_reactions.push_back(rxn);
+              _three_body_mixtures.push_back(reaction_mixture[rxn]);
+            }
+            break;
+
+          case(ReactionType::LINDEMANN_FALLOFF):
+            {
+              reaction_mixture[rxn] = this->add_mixture(reaction,false);
+              this->add_falloff(reaction, rxn, reaction_mixture[rxn],
+                                static_cast<const FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >&>(reaction).F(),
+                                _lindemann);
+            }
+            break;
+
+          case(ReactionType::TROE_FALLOFF):
+            {
+              reaction_mixture[rxn] = this->add_mixture(reaction,false);
+              this->add_falloff(reaction, rxn, reaction_mixture[rxn],
+                                static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F(),
+                                _troe);
+            }
+            break;
+
+          case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+            {
+              reaction_mixture[rxn] = this->add_mixture(reaction,true);
+              this->add_falloff(reaction, rxn, reaction_mixture[rxn],
+                                static_cast<const FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >&>(reaction).F(),
+                                _lindemann);
+            }
+            break;
+
+          case(ReactionType::TROE_FALLOFF_THREE_BODY):
+            {
+              reaction_mixture[rxn] = this->add_mixture(reaction,true);
+              this->add_falloff(reaction, rxn, reaction_mixture[rxn],
+                                static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F(),
+                                _troe);
+            }
+            break;
+
+          default:
+            {
+              antioch_error();
+            }
+          } // switch(reaction.type())
+
+        _rate_offsets.push_back(_rate_Cf.size());
+      }
+
+    // no mixture is flagged by n_mixtures
+    _reaction_mixture.resize(_n_reactions);
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        _reaction_mixture[rxn] = (reaction_mixture[rxn] == std::numeric_limits<unsigned int>::max())?
+                                  _n_mixtures:reaction_mixture[rxn];
+      }
+
+    std::sort(_log_species.begin(), _log_species.end());
+    _log_species.erase(std::unique(_log_species.begin(), _log_species.end()), _log_species.end());
+
+    this->build_dependencies();
+
+    this->build_log_rate_coefficients();
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::build_log_rate_coefficients()
+  {
+    using std::abs;
+    using std::log;
+
+    std::vector<CoeffType> Cf(_rate_Cf), eta(_rate_eta), Ea(_rate_Ea), D(_rate_D);
+    Cf.insert(Cf.end(), _lindemann.kinf_Cf.begin(), _lindemann.kinf_Cf.end());
+    Cf.insert(Cf.end(), _troe.kinf_Cf.begin(), _troe.kinf_Cf.end());
+    eta.insert(eta.end(), _lindemann.kinf_eta.begin(), _lindemann.kinf_eta.end());
+    eta.insert(eta.end(), _troe.kinf_eta.begin(), _troe.kinf_eta.end());
+    Ea.insert(Ea.end(), _lindemann.kinf_Ea.begin(), _lindemann.kinf_Ea.end());
+    Ea.insert(Ea.end(), _troe.kinf_Ea.begin(), _troe.kinf_Ea.end());
+    D.insert(D.end(), _lindemann.kinf_D.begin(), _lindemann.kinf_D.end());
+    D.insert(D.end(), _troe.kinf_D.begin(), _troe.kinf_D.end());
+
+    _log_rate_coefficients.resize(4 * Cf.size());
+    _log_rate_signs.resize(Cf.size());
+
+    // a zero preexponential factor gives ln|Cf| = -inf, thus k = 0
+    for(unsigned int ir = 0; ir < Cf.size(); ir++)
+      {
+        _log_rate_coefficients[4*ir]     = log(abs(Cf[ir]));
+        _log_rate_coefficients[4*ir + 1] = eta[ir];
+        _log_rate_coefficients[4*ir + 2] = -Ea[ir];
+        _log_rate_coefficients[4*ir + 3] = D[ir];
+        _log_rate_signs[ir] = (Cf[ir] < 0)?-1:1;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_log_rate_constants( unsigned int n_cells,
+                                                                   const std::vector<CoeffType>& basis,
+                                                                   std::vector<CoeffType>& log_k ) const
+  {
+    const unsigned int n = n_cells;
+    const unsigned int n_rates = this->n_rate_constants();
+
+    antioch_assert_equal_to( basis.size(), 4 * n );
+    antioch_assert_equal_to( log_k.size(), n_rates * n );
+
+    const CoeffType * b0 = &basis[0];
+    const CoeffType * b1 = &basis[n];
+    const CoeffType * b2 = &basis[2*n];
+    const CoeffType * b3 = &basis[3*n];
+
+    // inner dimension is 4, unrolled
+    for(unsigned int ir = 0; ir < n_rates; ir++)
+      {
+        const CoeffType * a = &_log_rate_coefficients[4*ir];
+        CoeffType * lk = &log_k[ir * n];
+        for(unsigned int c = 0; c < n; c++)
+          {
+            lk[c] = a[0] * b0[c] + a[1] * b1[c] + a[2] * b2[c] + a[3] * b3[c];
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::build_dependencies()
+  {
+    _dependency_offsets.assign(1,0);
+    _dependency_ids.clear();
+    _dependency_efficiencies.clear();
+    _reactant_dependencies.resize(_reactant_ids.size());
+    _product_dependencies.assign(_product_ids.size(), std::numeric_limits<unsigned int>::max());
+
+    std::vector<unsigned int> ids;
+    std::vector<CoeffType> efficiencies;
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        ids.assign(_reactant_ids.begin() + _reactant_offsets[rxn],
+                   _reactant_ids.begin() + _reactant_offsets[rxn+1]);
+        if(_reversible[rxn])
+          ids.insert(ids.end(), _product_ids.begin() + _product_offsets[rxn],
+                                _product_ids.begin() + _product_offsets[rxn+1]);
+
+        // third bodies
+        const unsigned int m = _reaction_mixture[rxn];
+        const CoeffType * eff = NULL;
+        if(m < _n_mixtures)
+          {
+            efficiencies.assign(_n_species, 1);
+            for(unsigned int i = _mixture_offsets[m]; i < _mixture_offsets[m+1]; i++)
+              efficiencies[_mixture_ids[i]] += _mixture_corrections[i];
+            eff = &efficiencies[0];
+
+            for(unsigned int s = 0; s < _n_species; s++)
+              {
+                if(eff[s] != 0)
+                  ids.push_back(s);
+              }
+          }
+        else if(_reaction_set.reaction(rxn).type() != ReactionType::ELEMENTARY &&
+                _reaction_set.reaction(rxn).type() != ReactionType::DUPLICATE)
+          {
+            // left to the ReactionSet, any species can be a third body
+            for(unsigned int s = 0; s < _n_species; s++)
+              ids.push_back(s);
+          }
+
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        const unsigned int begin = _dependency_ids.size();
+        for(unsigned int i = 0; i < ids.size(); i++)
+          {
+            _dependency_ids.push_back(ids[i]);
+            _dependency_efficiencies.push_back(eff?eff[ids[i]]:CoeffType(0));
+          }
+        _dependency_offsets.push_back(_dependency_ids.size());
+
+        for(unsigned int ro = _reactant_offsets[rxn]; ro < _reactant_offsets[rxn+1]; ro++)
+          _reactant_dependencies[ro] = begin + (std::lower_bound(ids.begin(), ids.end(), _reactant_ids[ro]) - ids.begin());
+
+        if(_reversible[rxn])
+          {
+            for(unsigned int po = _product_offsets[rxn]; po < _product_offsets[rxn+1]; po++)
+              _product_dependencies[po] = begin + (std::lower_bound(ids.begin(), ids.end(), _product_ids[po]) - ids.begin());
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  int CompiledReactionSet<CoeffType>::fractional_order()
+  {
+    return -1;
+  }
+
+  template<typename CoeffType>
+  inline
+  int CompiledReactionSet<CoeffType>::integer_order( const CoeffType& order )
+  {
+    // larger integer orders are not worth a loop of multiplications
+    if(order < 0 || order > 3)
+      return fractional_order();
+
+    const int n = static_cast<int>(order);
+    return (CoeffType(n) == order)?n:fractional_order();
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  StateType CompiledReactionSet<CoeffType>::integer_power( const StateType& c, int n )
+  {
+    switch(n)
+      {
+      case 0:
+        return Antioch::constant_clone(c,1);
+      case 1:
+        return c;
+      case 2:
+        return c * c;
+      case 3:
+        return c * c * c;
+      default:
+        antioch_error_msg("Only orders 0 to 3 are evaluated by multiplications");
+      }
+
+    return c;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_log_densities( const VectorStateType& molar_densities,
+                                                              std::vector<StateType>& log_densities ) const
+  {
+    if(_log_species.empty())
+      return;
+
+    log_densities.resize(_n_species, Antioch::zero_clone(molar_densities[0]));
+    for(unsigned int i = 0; i < _log_species.size(); i++)
+      log_densities[_log_species[i]] = ant_log(molar_densities[_log_species[i]]);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType CompiledReactionSet<CoeffType>::concentrations_product( unsigned int begin, unsigned int end,
+                                                                    const std::vector<unsigned int>& ids,
+                                                                    const std::vector<CoeffType>& orders,
+                                                                    const std::vector<int>& integer_orders,
+                                                                    const VectorStateType& molar_densities,
+                                                                    const std::vector<StateType>& log_densities ) const
+  {
+    StateType product = Antioch::constant_clone(molar_densities[0],1);
+    StateType log_product = Antioch::zero_clone(molar_densities[0]);
+    bool fractional = false;
+
+    for(unsigned int i = begin; i < end; i++)
+      {
+        if(integer_orders[i] == fractional_order())
+          {
+            log_product += orders[i] * log_densities[ids[i]];
+            fractional = true;
+          }
+        else
+          {
+            product *= integer_power(molar_densities[ids[i]], integer_orders[i]);
+          }
+      }
+
+    if(fractional)
+      product *= ant_exp(log_product);
+
+    return product;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::multiply_batch_concentrations( unsigned int n_cells,
+                                                                      unsigned int begin, unsigned int end,
+                                                                      const std::vector<unsigned int>& ids,
+                                                                      const std::vector<CoeffType>& orders,
+                                                                      const std::vector<int>& integer_orders,
+                                                                      const CoeffType * molar_densities,
+                                                                      unsigned int stride,
+                                                                      const std::vector<CoeffType>& log_X,
+                                                                      std::vector<CoeffType>& work,
+                                                                      std::vector<CoeffType>& product ) const
+  {
+    using std::exp;
+
+    const unsigned int n = n_cells;
+    bool fractional = false;
+
+    for(unsigned int i = begin; i < end; i++)
+      {
+        const CoeffType * X = molar_densities + ids[i] * stride;
+        switch(integer_orders[i])
+          {
+          case 0:
+            break;
+          case 1:
+            for(unsigned int c = 0; c < n; c++)
+              product[c] *= X[c];
+            break;
+          case 2:
+            for(unsigned int c = 0; c < n; c++)
+              product[c] *= X[c] * X[c];
+            break;
+          case 3:
+            for(unsigned int c = 0; c < n; c++)
+              product[c] *= X[c] * X[c] * X[c];
+            break;
+          default:
+            {
+              // accumulate the logarithms, a single exp at the end
+              const CoeffType order = orders[i];
+              const CoeffType * log_c = &log_X[ids[i] * n];
+              if(!fractional)
+                {
+                  for(unsigned int c = 0; c < n; c++)
+                    work[c] = order * log_c[c];
+                }
+              else
+                {
+                  for(unsigned int c = 0; c < n; c++)
+                    work[c] += order * log_c[c];
+                }
+              fractional = true;
+            }
+          }
+      }
+
+    if(fractional)
+      {
+        for(unsigned int c = 0; c < n; c++)
+          product[c] *= exp(work[c]);
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void CompiledReactionSet<CoeffType>::power_and_derivative( const StateType& c, const StateType& log_c,
+                                                             const CoeffType& order, int integer_order,
+                                                             StateType& value, StateType& derivative )
+  {
+    switch(integer_order)
+      {
+      case 0:
+        value      = Antioch::constant_clone(c,1);
+        derivative = Antioch::zero_clone(c);
+        break;
+      case 1:
+        value      = c;
+        derivative = Antioch::constant_clone(c,1);
+        break;
+      case 2:
+        value      = c * c;
+        derivative = 2 * c;
+        break;
+      case 3:
+        derivative = c * c;
+        value      = derivative * c;
+        derivative *= 3;
+        break;
+      default:
+        // fractional, both from ln(c)
+        value      = ant_exp(order * log_c);
+        derivative = order * ant_exp((order - 1) * log_c);
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_mixtures( const VectorStateType& molar_densities,
+                                                         std::vector<StateType>& M ) const
+  {
+    antioch_assert_equal_to(M.size(), _n_mixtures);
+
+    // total concentration once, then the non-unit efficiencies
+    StateType M_total = molar_densities[0];
+    for(unsigned int s = 1; s < _n_species; s++)
+      {
+        M_total += molar_densities[s];
+      }
+
+    for(unsigned int m = 0; m < _n_mixtures; m++)
+      {
+        M[m] = M_total;
+        for(unsigned int i = _mixture_offsets[m]; i < _mixture_offsets[m+1]; i++)
+          {
+            M[m] += _mixture_corrections[i] * molar_densities[_mixture_ids[i]];
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  StateType CompiledReactionSet<CoeffType>::falloff_value( const LindemannFalloff<CoeffType>& falloff, unsigned int /*i*/,
+                                                           const RateCoefficientCache<StateType>& cache,
+                                                           const StateType& M, const StateType& k0, const StateType& kinf )
+  {
+    return falloff(cache.T(), M, k0, kinf);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  StateType CompiledReactionSet<CoeffType>::falloff_value( const TroeFalloff<CoeffType>& falloff, unsigned int i,
+                                                           const RateCoefficientCache<StateType>& cache,
+                                                           const StateType& M, const StateType& k0, const StateType& kinf )
+  {
+    return falloff.F_from_Fcent(cache.T(), cache._Fcent[i], M, k0, kinf);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void CompiledReactionSet<CoeffType>::falloff_and_derivatives( const LindemannFalloff<CoeffType>& falloff, unsigned int /*i*/,
+                                                                const RateCoefficientCache<StateType>& cache,
+                                                                const StateType& M, const StateType& k0, const StateType& dk0_dT,
+                                                                const StateType& kinf, const StateType& dkinf_dT,
+                                                                StateType& F, StateType& dF_dT, StateType& dF_dM )
+  {
+    falloff.F_and_M_derivative(cache.T(), M, k0, dk0_dT, kinf, dkinf_dT, F, dF_dT, dF_dM);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void CompiledReactionSet<CoeffType>::falloff_and_derivatives( const TroeFalloff<CoeffType>& falloff, unsigned int i,
+                                                                const RateCoefficientCache<StateType>& cache,
+                                                                const StateType& M, const StateType& k0, const StateType& dk0_dT,
+                                                                const StateType& kinf, const StateType& dkinf_dT,
+                                                                StateType& F, StateType& dF_dT, StateType& dF_dM )
+  {
+    falloff.F_and_M_derivative_from_Fcent(cache.T(), cache._Fcent[i], cache._dFcent_dT[i],
+                                          M, k0, dk0_dT, kinf, dkinf_dT, F, dF_dT, dF_dM);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename FalloffType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::apply_falloff( const RateCoefficientCache<StateType>& cache,
+                                                      const std::vector<StateType>& M,
+                                                      const FalloffGroup<FalloffType>& group,
+                                                      unsigned int kinf_offset,
+                                                      VectorReactionsType& kfwd ) const
+  {
+    for(unsigned int i = 0; i < group.reactions.size(); i++)
+      {
+        const unsigned int rxn = group.reactions[i];
+        const StateType & Mi   = M[group.mixtures[i]];
+
+        const StateType & k0   = cache._k[rxn];
+        const StateType & kinf = cache._kinf[kinf_offset + i];
+
+        // k(T,[M]) = k0*[M]/(1 + [M]*k0/kinf) * F = k0 * ([M]^-1 + k0 * kinf^-1)^-1 * F
+        kfwd[rxn] = k0 / (ant_pow(Mi,-1) + k0 / kinf) * falloff_value(group.falloff[i], i, cache, Mi, k0, kinf);
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename FalloffType>
+  inline
+  void CompiledReactionSet<CoeffType>::apply_batch_falloff( unsigned int n_cells,
+                                                            const CoeffType * T,
+                                                            const CoeffType * kinf_all,
+                                                            const std::vector<CoeffType>& M,
+                                                            const FalloffGroup<FalloffType>& group,
+                                                            std::vector<CoeffType>& kfwd ) const
+  {
+    const unsigned int n = n_cells;
+
+    for(unsigned int i = 0; i < group.reactions.size(); i++)
+      {
+        CoeffType * k          = &kfwd[group.reactions[i] * n];
+        const CoeffType * Mi   = &M[group.mixtures[i] * n];
+        const CoeffType * kinf = &kinf_all[i * n];
+
+        for(unsigned int c = 0; c < n; c++)
+          {
+            const CoeffType k0 = k[c];
+
+            // k(T,[M]) = k0*[M]/(1 + [M]*k0/kinf) * F = k0 * ([M]^-1 + k0 * kinf^-1)^-1 * F
+            k[c] = k0 / (1/Mi[c] + k0 / kinf[c]) * group.falloff[i](T[c],Mi[c],k0,kinf[c]);
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename FalloffType>
+  inline
+  void CompiledReactionSet<CoeffType>::apply_falloff_and_derivatives( const RateCoefficientCache<StateType>& cache,
+                                                                      const std::vector<StateType>& M,
+                                                                      const FalloffGroup<FalloffType>& group,
+                                                                      unsigned int kinf_offset,
+                                                                      std::vector<StateType>& kfwd,
+                                                                      std::vector<StateType>& dkfwd_dT,
+                                                                      std::vector<StateType>& dkfwd_dM ) const
+  {
+    StateType f     = Antioch::zero_clone(cache.T());
+    StateType df_dT = Antioch::zero_clone(cache.T());
+    StateType df_dM = Antioch::zero_clone(cache.T());
+
+    for(unsigned int i = 0; i < group.reactions.size(); i++)
+      {
+        const unsigned int rxn = group.reactions[i];
+        const StateType & Mi   = M[group.mixtures[i]];
+
+        const StateType & k0       = cache._k[rxn];
+        const StateType & dk0_dT   = cache._dk_dT[rxn];
+        const StateType & kinf     = cache._kinf[kinf_offset + i];
+        const StateType & dkinf_dT = cache._dkinf_dT[kinf_offset + i];
+
+        falloff_and_derivatives(group.falloff[i], i, cache, Mi, k0, dk0_dT, kinf, dkinf_dT, f, df_dT, df_dM);
+
+        const StateType kf0  = k0 / (ant_pow(Mi,-1) + k0/kinf);
+        const StateType temp = (kinf/Mi + k0);
+
+        kfwd[rxn]     = kf0 * f;
+        dkfwd_dT[rxn] = f * kf0 * (dk0_dT/k0 - dk0_dT/temp + dkinf_dT * k0/(kinf * temp))
+                      + df_dT * kf0;
+        dkfwd_dM[rxn] = f * kf0 / (Mi + ant_pow(Mi,2) * k0/kinf) + df_dM * kf0;
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void CompiledReactionSet<CoeffType>::update_rate_coefficient_cache( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                      const VectorStateType& h_RT_minus_s_R,
+                                                                      const VectorStateType* dh_RT_minus_s_R_dT,
+                                                                      RateCoefficientCache<StateType>& cache ) const
+  {
+    if(_reaction_set.parameter_version() != _compiled_version)
+      antioch_error_msg("The reaction set was modified after it was compiled, compile() must be called again.");
+
+    const StateType & T   = conditions.T();
+    const StateType & lnT = conditions.temp_cache().lnT;
+    const bool derivatives = (dh_RT_minus_s_R_dT != NULL);
+
+    if(cache.holds(this, T, _compiled_version, derivatives))
+      return;
+
+    const StateType zero = Antioch::zero_clone(T);
+
+    // all the rate constants, same formula
+    // dk_dT = k * (eta/T + Ea/T^2 + D)
+    cache._k.assign(_n_reactions, zero);
+    if(derivatives)
+      cache._dk_dT.assign(_n_reactions, zero);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        for(unsigned int ir = _rate_offsets[rxn]; ir < _rate_offsets[rxn+1]; ir++)
+          {
+            const StateType k = _rate_Cf[ir] * ant_exp(_rate_eta[ir] * lnT - _rate_Ea[ir]/T + _rate_D[ir] * T);
+            cache._k[rxn] += k;
+            if(derivatives)
+              cache._dk_dT[rxn] += k * (_rate_eta[ir]/T + _rate_Ea[ir]/(T*T) + _rate_D[ir]);
+          }
+      }
+
+    // high pressure limits, Lindemann then Troe
+    const unsigned int n_lindemann = _lindemann.reactions.size();
+    const unsigned int n_troe      = _troe.reactions.size();
+
+    cache._kinf.resize(n_lindemann + n_troe, zero);
+    if(derivatives)
+      cache._dkinf_dT.resize(n_lindemann + n_troe, zero);
+
+    for(unsigned int i = 0; i < n_lindemann + n_troe; i++)
+      {
+        const bool is_lindemann = (i < n_lindemann);
+        const unsigned int j    = is_lindemann ? i : i - n_lindemann;
+        const CoeffType Cf  = is_lindemann ? _lindemann.kinf_Cf[j]  : _troe.kinf_Cf[j];
+        const CoeffType eta = is_lindemann ? _lindemann.kinf_eta[j] : _troe.kinf_eta[j];
+        const CoeffType Ea  = is_lindemann ? _lindemann.kinf_Ea[j]  : _troe.kinf_Ea[j];
+        const CoeffType D   = is_lindemann ? _lindemann.kinf_D[j]   : _troe.kinf_D[j];
+
+        cache._kinf[i] = Cf * ant_exp(eta * lnT - Ea/T + D * T);
+        if(derivatives)
+          cache._dkinf_dT[i] = cache._kinf[i] * (eta/T + Ea/(T*T) + D);
+      }
+
+    cache._Fcent.resize(n_troe, zero);
+    if(derivatives)
+      cache._dFcent_dT.resize(n_troe, zero);
+
+    for(unsigned int i = 0; i < n_troe; i++)
+      {
+        if(derivatives)
+          _troe.falloff[i].Fcent_and_derivatives(T, cache._Fcent[i], cache._dFcent_dT[i]);
+        else
+          cache._Fcent[i] = _troe.falloff[i].Fcent(T);
+      }
+
+    cache._keq.resize(_n_reactions, zero);
+    if(derivatives)
+      {
+        cache._dkeq_dT.resize(_n_reactions, zero);
+        _reaction_set.compute_equilibrium_constants_and_derivs(conditions, h_RT_minus_s_R, *dh_RT_minus_s_R_dT,
+                                                               cache._keq, cache._dkeq_dT);
+      }
+    else
+      {
+        _reaction_set.compute_equilibrium_constants(conditions, h_RT_minus_s_R, cache._keq);
+      }
+
+    cache._owner       = this;
+    cache._T           = T;
+    cache._version     = _compiled_version;
+    cache._derivatives = derivatives;
+    cache._valid       = true;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_forward_rate_coefficients( const RateCoefficientCache<StateType>& cache,
+                                                                          const VectorStateType& molar_densities,
+                                                                          std::vector<StateType>& M,
+                                                                          VectorReactionsType& kfwd ) const
+  {
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        kfwd[rxn] = cache._k[rxn];
+      }
+
+    if(_n_mixtures == 0)
+      return;
+
+    this->compute_mixtures(molar_densities, M);
+
+    // k(T,[M]) = [M] * alpha(T)
+    for(unsigned int i = 0; i < _three_body_reactions.size(); i++)
+      {
+        kfwd[_three_body_reactions[i]] *= M[_three_body_mixtures[i]];
+      }
+
+    this->apply_falloff(cache, M, _lindemann, 0, kfwd);
+    this->apply_falloff(cache, M, _troe, _lindemann.reactions.size(), kfwd);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_forward_rate_coefficients_and_derivatives( const RateCoefficientCache<StateType>& cache,
+                                                                                          const VectorStateType& molar_densities,
+                                                                                          std::vector<StateType>& M,
+                                                                                          std::vector<StateType>& kfwd,
+                                                                                          std::vector<StateType>& dkfwd_dT,
+                                                                                          std::vector<StateType>& dkfwd_dM ) const
+  {
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        kfwd[rxn]     = cache._k[rxn];
+        dkfwd_dT[rxn] = cache._dk_dT[rxn];
+        dkfwd_dM[rxn] = Antioch::zero_clone(cache.T());
+      }
+
+    if(_n_mixtures == 0)
+      return;
+
+    this->compute_mixtures(molar_densities, M);
+
+    // dk_dT = dalpha_dT * [M], dk_d[M] = alpha
+    for(unsigned int i = 0; i < _three_body_reactions.size(); i++)
+      {
+        const unsigned int rxn = _three_body_reactions[i];
+        const StateType & Mi   = M[_three_body_mixtures[i]];
+
+        dkfwd_dM[rxn]  = kfwd[rxn];
+        kfwd[rxn]     *= Mi;
+        dkfwd_dT[rxn] *= Mi;
+      }
+
+    this->apply_falloff_and_derivatives(cache, M, _lindemann, 0, kfwd, dkfwd_dT, dkfwd_dM);
+    this->apply_falloff_and_derivatives(cache, M, _troe, _lindemann.reactions.size(), kfwd, dkfwd_dT, dkfwd_dM);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                               const VectorStateType& molar_densities,
+                                                               const VectorStateType& h_RT_minus_s_R,
+                                                               VectorReactionsType& net_reaction_rates ) const
+  {
+    RateCoefficientCache<StateType> cache;
+    this->compute_reaction_rates(cache, conditions, molar_densities, h_RT_minus_s_R, net_reaction_rates);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates( RateCoefficientCache<StateType>& cache,
+                                                               const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                               const VectorStateType& molar_densities,
+                                                               const VectorStateType& h_RT_minus_s_R,
+                                                               VectorReactionsType& net_reaction_rates ) const
+  {
+    KineticsWorkspace<StateType> workspace(_reaction_set, conditions.T());
+    this->compute_reaction_rates(workspace, cache, conditions, molar_densities, h_RT_minus_s_R, net_reaction_rates);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates( KineticsWorkspace<StateType>& workspace,
+                                                               RateCoefficientCache<StateType>& cache,
+                                                               const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                               const VectorStateType& molar_densities,
+                                                               const VectorStateType& h_RT_minus_s_R,
+                                                               VectorReactionsType& net_reaction_rates ) const
+  {
+    antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    // rate constants and equilibrium constants
+    this->update_rate_coefficient_cache(conditions, h_RT_minus_s_R, static_cast<const VectorStateType*>(NULL), cache);
+    const std::vector<StateType> & keq = cache._keq;
+
+    // forward rate coefficients, stored in place
+    this->compute_forward_rate_coefficients(cache, molar_densities, workspace.work_array(MIXTURES, _n_mixtures),
+                                            net_reaction_rates);
+
+    std::vector<StateType> & log_densities = workspace.work_array(LOG_DENSITIES, 0);
+    this->compute_log_densities(molar_densities, log_densities);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        const StateType kfwd = net_reaction_rates[rxn];
+
+        StateType kfwd_times_reactants = kfwd *
+          this->concentrations_product(_reactant_offsets[rxn], _reactant_offsets[rxn+1],
+                                       _reactant_ids, _reactant_orders, _reactant_integer_orders,
+                                       molar_densities, log_densities);
+
+        if(_reversible[rxn])
+          {
+            const StateType & Keq = keq[rxn];
+
+            StateType kbkwd_times_products = kfwd/Keq *
+              this->concentrations_product(_product_offsets[rxn], _product_offsets[rxn+1],
+                                           _product_ids, _product_orders, _product_integer_orders,
+                                           molar_densities, log_densities);
+
+            // If we have an equilibrium constant of zero, our reverse
+            // reaction rate should be infinity or a user-specified
+            // maximum rate, not NaN.
+            typename Antioch::rebind<StateType,bool>::type is_nonzero = (Keq != Antioch::zero_clone(Keq));
+            kfwd_times_reactants -= Antioch::if_else(is_nonzero, kbkwd_times_products,
+                                                     Antioch::constant_clone(Keq, _max_rate[rxn]));
+          }
+
+        net_reaction_rates[rxn] = kfwd_times_reactants;
+      }
+
+    if(!_photochemical_reactions.empty())
+      {
+        const StateType P0_RT = _P0_R/conditions.T();
+        for(unsigned int i = 0; i < _photochemical_reactions.size(); i++)
+          {
+            const unsigned int rxn = _photochemical_reactions[i];
+            net_reaction_rates[rxn] = _reaction_set.reaction(rxn).compute_rate_of_progress(molar_densities, conditions, P0_RT, h_RT_minus_s_R);
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_reaction_rates( unsigned int n_cells,
+                                                                     const std::vector<CoeffType>& T,
+                                                                     const std::vector<CoeffType>& molar_densities,
+                                                                     const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                     std::vector<CoeffType>& net_reaction_rates ) const
+  {
+    KineticsWorkspace<CoeffType> workspace(_reaction_set, CoeffType(0));
+    this->compute_batch_reaction_rates(workspace, n_cells, T, molar_densities, h_RT_minus_s_R, net_reaction_rates);
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_reaction_rates( KineticsWorkspace<CoeffType>& workspace,
+                                                                     unsigned int n_cells,
+                                                                     const std::vector<CoeffType>& T,
+                                                                     const std::vector<CoeffType>& molar_densities,
+                                                                     const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                     std::vector<CoeffType>& net_reaction_rates ) const
+  {
+    this->compute_batch_reaction_rates(workspace, n_cells, 0, n_cells, T, molar_densities, h_RT_minus_s_R, net_reaction_rates);
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_reaction_rates( KineticsWorkspace<CoeffType>& workspace,
+                                                                     unsigned int n_cells,
+                                                                     unsigned int begin, unsigned int end,
+                                                                     const std::vector<CoeffType>& T,
+                                                                     const std::vector<CoeffType>& molar_densities,
+                                                                     const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                     std::vector<CoeffType>& net_reaction_rates ) const
+  {
+    using std::exp;
+    using std::log;
+
+    antioch_assert_less_equal( begin, end );
+    antioch_assert_less_equal( end, n_cells );
+    antioch_assert_equal_to( T.size(), n_cells );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() * n_cells );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() * n_cells );
+    antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() * (end - begin) );
+
+    if(_reaction_set.parameter_version() != _compiled_version)
+      antioch_error_msg("The reaction set was modified after it was compiled, compile() must be called again.");
+
+    if(!_photochemical_reactions.empty())
+      antioch_not_implemented_msg("Photochemical reactions need the KineticsConditions particle fluxes, use compute_reaction_rates()");
+
+    if(begin == end)
+      return;
+
+    // cells of the range, the state of cell c is at begin + c
+    const unsigned int n = end - begin;
+    const CoeffType * T_range = &T[0] + begin;
+    const CoeffType * X_range = &molar_densities[0] + begin;
+
+    // temperature basis [1, ln(T), 1/T, T], once per cell
+    std::vector<CoeffType> & basis = workspace.work_array(BATCH_BASIS, 4 * n);
+    for(unsigned int c = 0; c < n; c++)
+      {
+        basis[c]       = 1;
+        basis[n + c]   = log(T_range[c]);
+        basis[2*n + c] = 1/T_range[c];
+        basis[3*n + c] = T_range[c];
+      }
+
+    // all the rate constants at once, in log space, then back
+    std::vector<CoeffType> & rate_constants = workspace.work_array(BATCH_RATE_CONSTANTS, this->n_rate_constants() * n);
+    this->compute_log_rate_constants(n, basis, rate_constants);
+
+    for(unsigned int i = 0; i < rate_constants.size(); i++)
+      rate_constants[i] = exp(rate_constants[i]);
+
+    for(unsigned int ir = 0; ir < this->n_rate_constants(); ir++)
+      {
+        if(_log_rate_signs[ir] < 0)
+          {
+            CoeffType * k = &rate_constants[ir * n];
+            for(unsigned int c = 0; c < n; c++)
+              k[c] = -k[c];
+          }
+      }
+
+    // forward rate coefficients, stored in place
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        CoeffType * k = &net_reaction_rates[rxn * n];
+        for(unsigned int c = 0; c < n; c++)
+          k[c] = 0;
+
+        for(unsigned int ir = _rate_offsets[rxn]; ir < _rate_offsets[rxn+1]; ir++)
+          {
+            const CoeffType * kr = &rate_constants[ir * n];
+            for(unsigned int c = 0; c < n; c++)
+              k[c] += kr[c];
+          }
+      }
+
+    if(_n_mixtures != 0)
+      {
+        // total concentration once, then the non-unit efficiencies
+        std::vector<CoeffType> & M_total = workspace.work_array(BATCH_M_TOTAL, n);
+        std::fill(M_total.begin(), M_total.end(), CoeffType(0));
+        for(unsigned int s = 0; s < _n_species; s++)
+          {
+            const CoeffType * X = X_range + s * n_cells;
+            for(unsigned int c = 0; c < n; c++)
+              M_total[c] += X[c];
+          }
+
+        std::vector<CoeffType> & M = workspace.work_array(MIXTURES, _n_mixtures * n);
+        for(unsigned int m = 0; m < _n_mixtures; m++)
+          {
+            CoeffType * Mm = &M[m * n];
+            for(unsigned int c = 0; c < n; c++)
+              Mm[c] = M_total[c];
+
+            for(unsigned int i = _mixture_offsets[m]; i < _mixture_offsets[m+1]; i++)
+              {
+                const CoeffType eff = _mixture_corrections[i];
+                const CoeffType * X = X_range + _mixture_ids[i] * n_cells;
+                for(unsigned int c = 0; c < n; c++)
+                  Mm[c] += eff * X[c];
+              }
+          }
+
+        // k(T,[M]) = [M] * alpha(T)
+        for(unsigned int i = 0; i < _three_body_reactions.size(); i++)
+          {
+            CoeffType * k = &net_reaction_rates[_three_body_reactions[i] * n];
+            const CoeffType * Mm = &M[_three_body_mixtures[i] * n];
+            for(unsigned int c = 0; c < n; c++)
+              k[c] *= Mm[c];
+          }
+
+        // high pressure limits after the reactions rate constants
+        const unsigned int lindemann_kinf = _rate_Cf.size();
+        const unsigned int troe_kinf      = lindemann_kinf + _lindemann.reactions.size();
+
+        if(!_lindemann.reactions.empty())
+          this->apply_batch_falloff(n, T_range, &rate_constants[lindemann_kinf * n], M, _lindemann, net_reaction_rates);
+        if(!_troe.reactions.empty())
+          this->apply_batch_falloff(n, T_range, &rate_constants[troe_kinf * n], M, _troe, net_reaction_rates);
+      }
+
+    // all the equilibrium constants at once,
+    // ln(K) = gamma ln(P0/(RT)) - nu^T (h/RT - s/R)
+    const StoichiometricMatrix<CoeffType>& nu = _reaction_set.stoichiometric_matrix();
+
+    std::vector<CoeffType> & keq = workspace.work_array(BATCH_KEQ, _n_reactions * n);
+    nu.multiply_transpose_cells(n_cells, begin, end, h_RT_minus_s_R, keq);
+
+    std::vector<CoeffType> & log_P0_RT = workspace.work_array(BATCH_LOG_P0_RT, n);
+    for(unsigned int c = 0; c < n; c++)
+      log_P0_RT[c] = log(_P0_R * basis[2*n + c]);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        const CoeffType gamma = nu.gamma()[rxn];
+        CoeffType * K = &keq[rxn * n];
+        for(unsigned int c = 0; c < n; c++)
+          K[c] = gamma * log_P0_RT[c] - K[c];
+      }
+
+    for(unsigned int i = 0; i < keq.size(); i++)
+      keq[i] = exp(keq[i]);
+
+    // logarithms of the concentrations with a fractional order
+    std::vector<CoeffType> & log_X = workspace.work_array(LOG_DENSITIES, _log_species.empty() ? 0 : _n_species * n);
+    if(!_log_species.empty())
+      {
+        for(unsigned int i = 0; i < _log_species.size(); i++)
+          {
+            const unsigned int s = _log_species[i];
+            for(unsigned int c = 0; c < n; c++)
+              log_X[s * n + c] = log(X_range[s * n_cells + c]);
+          }
+      }
+
+    // rates of progress
+    std::vector<CoeffType> & fwd  = workspace.work_array(BATCH_FWD, n);
+    std::vector<CoeffType> & bkwd = workspace.work_array(BATCH_BKWD, n);
+    std::vector<CoeffType> & work = workspace.work_array(BATCH_WORK, n);
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        CoeffType * R = &net_reaction_rates[rxn * n];
+
+        for(unsigned int c = 0; c < n; c++)
+          fwd[c] = R[c];
+        this->multiply_batch_concentrations(n, _reactant_offsets[rxn], _reactant_offsets[rxn+1],
+                                            _reactant_ids, _reactant_orders, _reactant_integer_orders,
+                                            X_range, n_cells, log_X, work, fwd);
+
+        if(_reversible[rxn])
+          {
+            const CoeffType * K = &keq[rxn * n];
+            for(unsigned int c = 0; c < n; c++)
+              bkwd[c] = R[c]/K[c];
+            this->multiply_batch_concentrations(n, _product_offsets[rxn], _product_offsets[rxn+1],
+                                                _product_ids, _product_orders, _product_integer_orders,
+                                                X_range, n_cells, log_X, work, bkwd);
+
+            // If we have an equilibrium constant of zero, our reverse
+            // reaction rate should be infinity or a user-specified
+            // maximum rate, not NaN.
+            for(unsigned int c = 0; c < n; c++)
+              R[c] = fwd[c] - ((K[c] != 0)?bkwd[c]:_max_rate[rxn]);
+          }
+        else
+          {
+            for(unsigned int c = 0; c < n; c++)
+              R[c] = fwd[c];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                          const VectorStateType& molar_densities,
+                                                                          const VectorStateType& h_RT_minus_s_R,
+                                                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                          VectorReactionsType& net_reaction_rates,
+                                                                          VectorReactionsType& dnet_rate_dT,
+                                                                          MatrixReactionsType& dnet_rate_dX_s ) const
+  {
+    KineticsWorkspace<StateType> workspace(_reaction_set, conditions.T());
+    RateCoefficientCache<StateType> cache;
+    this->compute_reaction_rates_and_derivs(workspace, cache, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                            net_reaction_rates, dnet_rate_dT, dnet_rate_dX_s);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                                                          RateCoefficientCache<StateType>& cache,
+                                                                          const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                          const VectorStateType& molar_densities,
+                                                                          const VectorStateType& h_RT_minus_s_R,
+                                                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                          VectorReactionsType& net_reaction_rates,
+                                                                          VectorReactionsType& dnet_rate_dT,
+                                                                          MatrixReactionsType& dnet_rate_dX_s ) const
+  {
+    antioch_assert_equal_to( dnet_rate_dX_s.size(), this->n_reactions() );
+
+    std::vector<StateType> & dnet_rate_dX = workspace.work_array(DNET_RATE_DX, this->n_dependencies());
+
+    this->compute_reaction_rates_and_sparse_derivs(workspace, cache, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                   net_reaction_rates, dnet_rate_dT, dnet_rate_dX);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        Antioch::set_zero(dnet_rate_dX_s[rxn]);
+        for(unsigned int k = _dependency_offsets[rxn]; k < _dependency_offsets[rxn+1]; k++)
+          {
+            dnet_rate_dX_s[rxn][_dependency_ids[k]] = dnet_rate_dX[k];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates_and_sparse_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                 const VectorStateType& molar_densities,
+                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                 VectorReactionsType& net_reaction_rates,
+                                                                                 VectorReactionsType& dnet_rate_dT,
+                                                                                 VectorDependenciesType& dnet_rate_dX ) const
+  {
+    RateCoefficientCache<StateType> cache;
+    this->compute_reaction_rates_and_sparse_derivs(cache, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                   net_reaction_rates, dnet_rate_dT, dnet_rate_dX);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates_and_sparse_derivs( RateCoefficientCache<StateType>& cache,
+                                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                 const VectorStateType& molar_densities,
+                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                 VectorReactionsType& net_reaction_rates,
+                                                                                 VectorReactionsType& dnet_rate_dT,
+                                                                                 VectorDependenciesType& dnet_rate_dX ) const
+  {
+    KineticsWorkspace<StateType> workspace(_reaction_set, conditions.T());
+    this->compute_reaction_rates_and_sparse_derivs(workspace, cache, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                   net_reaction_rates, dnet_rate_dT, dnet_rate_dX);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates_and_sparse_derivs( KineticsWorkspace<StateType>& workspace,
+                                                                                 RateCoefficientCache<StateType>& cache,
+                                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                 const VectorStateType& molar_densities,
+                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                 VectorReactionsType& net_reaction_rates,
+                                                                                 VectorReactionsType& dnet_rate_dT,
+                                                                                 VectorDependenciesType& dnet_rate_dX ) const
+  {
+    antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
+    antioch_assert_equal_to( dnet_rate_dT.size(), this->n_reactions() );
+    antioch_assert_equal_to( dnet_rate_dX.size(), this->n_dependencies() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+
+    const StateType & T = conditions.T();
+
+    std::vector<StateType> & kfwd     = workspace.work_array(KFWD, _n_reactions);
+    std::vector<StateType> & dkfwd_dT = workspace.work_array(DKFWD_DT, _n_reactions);
+    std::vector<StateType> & dkfwd_dM = workspace.work_array(DKFWD_DM, _n_reactions);
+
+    // rate constants and equilibrium constants, and derivatives
+    this->update_rate_coefficient_cache(conditions, h_RT_minus_s_R, &dh_RT_minus_s_R_dT, cache);
+    const std::vector<StateType> & keq     = cache._keq;
+    const std::vector<StateType> & dkeq_dT = cache._dkeq_dT;
+
+    this->compute_forward_rate_coefficients_and_derivatives(cache, molar_densities, workspace.work_array(MIXTURES, _n_mixtures),
+                                                            kfwd, dkfwd_dT, dkfwd_dM);
+
+    // concentrations to their partial order and derivative
+    std::vector<StateType> & val  = workspace.work_array(VALUES, 0);
+    std::vector<StateType> & dval = workspace.work_array(DVALUES, 0);
+
+    std::vector<StateType> & log_densities = workspace.work_array(LOG_DENSITIES, 0);
+    this->compute_log_densities(molar_densities, log_densities);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        for(unsigned int k = _dependency_offsets[rxn]; k < _dependency_offsets[rxn+1]; k++)
+          dnet_rate_dX[k] = Antioch::zero_clone(T);
+
+        // Rfwd & derivatives
+        const unsigned int r_begin = _reactant_offsets[rxn];
+        const unsigned int n_r     = _reactant_offsets[rxn+1] - r_begin;
+        val.resize(n_r, Antioch::zero_clone(T));
+        dval.resize(n_r, Antioch::zero_clone(T));
+
+        StateType facfwd = Antioch::constant_clone(T,1);
+        for(unsigned int ro = 0; ro < n_r; ro++)
+          {
+            const unsigned int i = r_begin + ro;
+            const unsigned int s = _reactant_ids[i];
+            power_and_derivative(molar_densities[s], log_densities.empty() ? molar_densities[s] : log_densities[s],
+                                 _reactant_orders[i], _reactant_integer_orders[i], val[ro], dval[ro]);
+            facfwd  *= val[ro];
+          }
+
+        for(unsigned int ro = 0; ro < n_r; ro++)
+          {
+            StateType dRfwd_dX = kfwd[rxn] * dval[ro];
+            for(unsigned int ri = 0; ri < n_r; ri++)
+              {
+                if(ri != ro)
+                  dRfwd_dX *= val[ri];
+              }
+            dnet_rate_dX[_reactant_dependencies[r_begin + ro]] += dRfwd_dX;
+          }
+
+        net_reaction_rates[rxn] = facfwd * kfwd[rxn];
+        dnet_rate_dT[rxn]       = facfwd * dkfwd_dT[rxn];
+        StateType dnet_rate_dM  = facfwd * dkfwd_dM[rxn];
+
+        if(_reversible[rxn])
+          {
+            const StateType & K = keq[rxn];
+
+            const StateType kbkwd     = kfwd[rxn]/K;
+            const StateType dkbkwd_dT = (dkfwd_dT[rxn] - kbkwd*dkeq_dT[rxn])/K;
+
+            // Rbkwd & derivatives
+            const unsigned int p_begin = _product_offsets[rxn];
+            const unsigned int n_p     = _product_offsets[rxn+1] - p_begin;
+            val.resize(n_p, Antioch::zero_clone(T));
+            dval.resize(n_p, Antioch::zero_clone(T));
+
+            StateType facbkwd = Antioch::constant_clone(T,1);
+            for(unsigned int po = 0; po < n_p; po++)
+              {
+                const unsigned int i = p_begin + po;
+                const unsigned int s = _product_ids[i];
+                power_and_derivative(molar_densities[s], log_densities.empty() ? molar_densities[s] : log_densities[s],
+                                     _product_orders[i], _product_integer_orders[i], val[po], dval[po]);
+                facbkwd *= val[po];
+              }
+
+            // If we have an equilibrium constant of zero, our reverse
+            // reaction rate should be infinity or a user-specified
+            // maximum rate, not NaN, and its derivatives are zero.
+            typename Antioch::rebind<StateType,bool>::type is_nonzero = (K != Antioch::zero_clone(K));
+
+            for(unsigned int po = 0; po < n_p; po++)
+              {
+                StateType dRbkwd_dX = kbkwd * dval[po];
+                for(unsigned int pi = 0; pi < n_p; pi++)
+                  {
+                    if(pi != po)
+                      dRbkwd_dX *= val[pi];
+                  }
+                dnet_rate_dX[_product_dependencies[p_begin + po]] -=
+                  Antioch::if_else(is_nonzero, dRbkwd_dX, Antioch::zero_clone(K));
+              }
+
+            net_reaction_rates[rxn] -= Antioch::if_else(is_nonzero, facbkwd * kbkwd,
+                                                        Antioch::constant_clone(K, _max_rate[rxn]));
+            dnet_rate_dT[rxn]       -= Antioch::if_else(is_nonzero, facbkwd * dkbkwd_dT,
+                                                        Antioch::zero_clone(K));
+            dnet_rate_dM            -= Antioch::if_else(is_nonzero, facbkwd * dkfwd_dM[rxn]/K,
+                                                        Antioch::zero_clone(K));
+          }
+
+        // dR_dX_s += dR_d[M] * efficiency_s
+        if(_reaction_mixture[rxn] < _n_mixtures)
+          {
+            for(unsigned int k = _dependency_offsets[rxn]; k < _dependency_offsets[rxn+1]; k++)
+              {
+                dnet_rate_dX[k] += _dependency_efficiencies[k] * dnet_rate_dM;
+              }
+          }
+      }
+
+    if(!_photochemical_reactions.empty())
+      {
+        const StateType P0_RT = _P0_R/T;
+        std::vector<StateType> & dnet_rate_dX_s = workspace.work_array(DNET_RATE_DX_S, _n_species);
+        Antioch::set_zero(dnet_rate_dX_s);
+        for(unsigned int i = 0; i < _photochemical_reactions.size(); i++)
+          {
+            const unsigned int rxn = _photochemical_reactions[i];
+            _reaction_set.reaction(rxn).compute_rate_of_progress_and_derivatives( molar_densities, _reaction_set.chemical_mixture(),
+                                                                                  conditions, P0_RT, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                                                  net_reaction_rates[rxn],
+                                                                                  dnet_rate_dT[rxn],
+                                                                                  dnet_rate_dX_s );
+            for(unsigned int k = _dependency_offsets[rxn]; k < _dependency_offsets[rxn+1]; k++)
+              dnet_rate_dX[k] = dnet_rate_dX_s[_dependency_ids[k]];
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_COMPILED_REACTION_SET_H
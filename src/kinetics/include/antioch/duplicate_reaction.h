@@ -73,8 +73,8 @@ namespace Antioch
     
     ~DuplicateReaction();
 
-    //!
-    template <typename StateType, typename VectorStateType>
+    //! \p KineticsClass is the type of the rate constants, KineticsType dispatches at each call
+    template <typename StateType, typename VectorStateType, typename KineticsClass = KineticsType<CoeffType> >
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions ) const;
     
@@ -110,16 +110,16 @@ namespace Antioch
 
 
   template <typename CoeffType>
-  template<typename StateType, typename VectorStateType>
+  template<typename StateType, typename VectorStateType, typename KineticsClass>
   inline
   StateType DuplicateReaction<CoeffType>::compute_forward_rate_coefficient
     ( const VectorStateType& /* molar_densities */,
       const KineticsConditions<StateType,VectorStateType>& conditions) const
   {
-    StateType kfwd = (*this->_forward_rate[0])(conditions);
+    StateType kfwd = static_cast<const KineticsClass&>(*this->_forward_rate[0])(conditions);
     for(unsigned int ir = 1; ir < this->_forward_rate.size(); ir++)
       {
-        kfwd += (*this->_forward_rate[ir])(conditions);
+        kfwd += static_cast<const KineticsClass&>(*this->_forward_rate[ir])(conditions);
       }
 
     antioch_assert(!has_nan(kfwd));
@@ -73,8 +73,8 @@ namespace Antioch
     
     ~ElementaryReaction();
 
-    //!
-    template <typename StateType, typename VectorStateType>
+    //! \p KineticsClass is the type of the rate constants, KineticsType dispatches at each call
+    template <typename StateType, typename VectorStateType, typename KineticsClass = KineticsType<CoeffType> >
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions ) const; 
     
@@ -113,7 +113,7 @@ namespace Antioch
 
 
   template<typename CoeffType>
-  template<typename StateType, typename VectorStateType>
+  template<typename StateType, typename VectorStateType, typename KineticsClass>
   inline
   StateType ElementaryReaction<CoeffType>::compute_forward_rate_coefficient
     ( const VectorStateType& /* molar_densities */,
@@ -122,7 +122,7 @@ namespace Antioch
     antioch_assert_equal_to(1, Reaction<CoeffType>::_forward_rate.size());
 
     //k(T,[M]) = alpha(T)
-    return (*this->_forward_rate[0])(conditions);
+    return static_cast<const KineticsClass&>(*this->_forward_rate[0])(conditions);
   }
 
   template<typename CoeffType>
@@ -108,8 +108,8 @@ namespace Antioch
     
     virtual ~FalloffReaction();
 
-    //!
-    template <typename StateType, typename VectorStateType>
+    //! \p KineticsClass is the type of the rate constants, KineticsType dispatches at each call
+    template <typename StateType, typename VectorStateType, typename KineticsClass = KineticsType<CoeffType> >
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions ) const;
     
@@ -169,7 +169,7 @@ namespace Antioch
   }
 
   template<typename CoeffType, typename FalloffType>
-  template<typename StateType, typename VectorStateType>
+  template<typename StateType, typename VectorStateType, typename KineticsClass>
   inline
   StateType FalloffReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                                                       const KineticsConditions<StateType,VectorStateType>& conditions  ) const
@@ -181,8 +181,8 @@ namespace Antioch
         M += molar_densities[i];
     }
 
-    const StateType k0   = (*this->_forward_rate[0])(conditions);
-    const StateType kinf = (*this->_forward_rate[1])(conditions);
+    const StateType k0   = static_cast<const KineticsClass&>(*this->_forward_rate[0])(conditions);
+    const StateType kinf = static_cast<const KineticsClass&>(*this->_forward_rate[1])(conditions);
 
     StateType kfwd = k0 / (ant_pow(M,-1) + k0 / kinf) * _F(conditions.T(),M,k0,kinf);
 
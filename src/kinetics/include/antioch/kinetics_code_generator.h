@@ -0,0 +1,1098 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_KINETICS_CODE_GENERATOR_H
+#define ANTIOCH_KINETICS_CODE_GENERATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/physical_constants.h"
+#include "antioch/math_constants.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/reaction_set.h"
+#include "antioch/stoichiometric_matrix.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/falloff_reaction.h"
+#include "antioch/falloff_threebody_reaction.h"
+#include "antioch/lindemann_falloff.h"
+#include "antioch/troe_falloff.h"
+#include "antioch/nasa_mixture.h"
+#include "antioch/nasa7_curve_fit.h"
+#include "antioch/nasa9_curve_fit.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Antioch
+{
+  //! Writes a reaction set and its thermodynamics as a standalone C++ header
+  /*!
+   * The generated header only includes <cmath> and defines a class
+   * whose static functions mirror the thermodynamics and
+   * KineticsEvaluator evaluations, without the KineticsConditions:
+   * \code
+   *   h_RT_minus_s_R( T, h_RT_minus_s_R );
+   *   dh_RT_minus_s_R_dT( T, dh_RT_minus_s_R_dT );
+   *   compute_mass_sources( T, molar_densities, h_RT_minus_s_R, mass_sources );
+   *   compute_mass_sources_and_derivs( T, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+   *                                    mass_sources, dmass_dT, dmass_drho_s );
+   * \endcode
+   * Every loop over the species and the reactions is unrolled and every
+   * parameter is written as a literal, so the compiler sees the whole
+   * mechanism. The kinetics models are written as Van't Hoff
+   * expressions (see CompiledReactionSet), and only the non-zero terms
+   * of the Jacobian are written.
+   *
+   * The functions are templated on a scalar StateType, the curve fit
+   * interval being chosen by a branch. Temperatures below (above)
+   * the curve fits use their first (last) interval. Photochemical
+   * reactions are not supported.
+   */
+  template<typename CoeffType, typename NASAFit>
+  class KineticsCodeGenerator
+  {
+  public:
+
+    KineticsCodeGenerator( const ReactionSet<CoeffType>& reaction_set,
+                           const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture );
+
+    ~KineticsCodeGenerator();
+
+    //! Writes the header, \p name is the name of the generated class
+    void write( std::ostream& os, const std::string& name ) const;
+
+  private:
+
+    KineticsCodeGenerator();
+
+    //! \f$\frac{h}{RT} - \frac{s}{R}\f$, or its temperature derivative if \p derivative
+    void write_thermo( std::ostream& os, bool derivative ) const;
+
+    //! Mass sources, and their derivatives if \p derivs
+    void write_mass_sources( std::ostream& os, bool derivs ) const;
+
+    //! Rate of progress R_rxn, and its derivatives if \p derivs
+    /*!
+     * The derivatives are dR_rxn_dT, dR_rxn_dM for the reactions
+     * with a mixture, and dR_rxn_dcs for the reactants and products.
+     */
+    void write_rate_of_progress( std::ostream& os, unsigned int rxn, bool derivs ) const;
+
+    //! Forward rate coefficient kf_rxn, dkf_rxn_dT and dkf_rxn_dM if \p derivs
+    void write_forward_rate_coefficient( std::ostream& os, unsigned int rxn, bool derivs ) const;
+
+    //! Rate constant \p k, and d\p k_dT if \p derivs
+    void write_rate_constant( std::ostream& os, const KineticsType<CoeffType>& rate,
+                              const std::string& k, bool derivs ) const;
+
+    //! Troe function F_rxn, dF_rxn_dT and dF_rxn_dM if \p derivs
+    void write_troe_falloff( std::ostream& os, const TroeFalloff<CoeffType>& falloff,
+                             const std::string& rxn, bool derivs ) const;
+
+    //! \f$[M]\f$ of reaction \p rxn, zero efficiencies if it has no mixture
+    void mixture_efficiencies( unsigned int rxn, std::vector<CoeffType>& efficiencies ) const;
+
+    //! Species and partial orders of the reactants (or the products), repeated species merged
+    void species_orders( unsigned int rxn, bool reactants,
+                         std::vector<std::pair<unsigned int,CoeffType> >& orders ) const;
+
+    //! Factors of \f$\prod_s c_s^{\nu_s}\f$, or of its derivative with respect to \p species
+    /*!
+     * \returns false if the product does not depend on \p species.
+     */
+    static bool concentrations_product( const std::vector<std::pair<unsigned int,CoeffType> >& orders,
+                                        unsigned int species,
+                                        std::vector<std::string>& factors );
+
+    //! \f$\frac{h}{RT} - \frac{s}{R}\f$ of a NASA7 fit on \p interval
+    static std::string h_RT_minus_s_R( const NASA7CurveFit<CoeffType>& fit, unsigned int interval );
+
+    static std::string dh_RT_minus_s_R_dT( const NASA7CurveFit<CoeffType>& fit, unsigned int interval );
+
+    //! \f$\frac{h}{RT} - \frac{s}{R}\f$ of a NASA9 (and CEA) fit on \p interval
+    static std::string h_RT_minus_s_R( const NASA9CurveFit<CoeffType>& fit, unsigned int interval );
+
+    static std::string dh_RT_minus_s_R_dT( const NASA9CurveFit<CoeffType>& fit, unsigned int interval );
+
+    //! Round-trip literal of \p x
+    static std::string literal( const CoeffType& x );
+
+    //! Adds \p coeff * \p expr to \p sum, \p expr being empty for a constant
+    static void add_term( std::string& sum, const CoeffType& coeff, const std::string& expr );
+
+    //! Adds the expression \p expr to \p sum, nothing if \p expr is empty
+    static void add_sum( std::string& sum, const std::string& expr );
+
+    //! \p sum, or zero if empty
+    static std::string sum_or_zero( const std::string& sum );
+
+    //! c[0] + x*(c[1] + x*(...)), trailing zeros dropped
+    static std::string horner( const std::vector<CoeffType>& c, const std::string& x );
+
+    //! \p factors joined by '*', one if empty
+    static std::string product( const std::vector<std::string>& factors );
+
+    //! true if \p code uses the variable \p name
+    static bool uses( const std::string& code, const std::string& name );
+
+    //! Declares the variables used by \p body, then writes \p body
+    void write_body( std::ostream& os, const std::string& body, bool derivs ) const;
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    const NASAThermoMixture<CoeffType,NASAFit>& _thermo_mixture;
+
+    const std::string _indent;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  KineticsCodeGenerator<CoeffType,NASAFit>::KineticsCodeGenerator( const ReactionSet<CoeffType>& reaction_set,
+                                                                   const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture )
+    : _reaction_set(reaction_set),
+      _thermo_mixture(thermo_mixture),
+      _indent("    ")
+  {
+    antioch_assert_equal_to(reaction_set.n_species(), thermo_mixture.chemical_mixture().n_species());
+
+    for(unsigned int rxn = 0; rxn < reaction_set.n_reactions(); rxn++)
+      {
+        const Reaction<CoeffType>& reaction = reaction_set.reaction(rxn);
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          {
+            CoeffType Cf, eta, Ea, D;
+            if(!CompiledReactionSet<CoeffType>::rate_parameters(reaction.forward_rate(ir), Cf, eta, Ea, D))
+              antioch_error_msg("ERROR: no code can be generated for the kinetics model of reaction " + reaction.equation());
+          }
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  KineticsCodeGenerator<CoeffType,NASAFit>::~KineticsCodeGenerator()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write( std::ostream& os, const std::string& name ) const
+  {
+    std::string guard = "ANTIOCH_GENERATED_" + name + "_H";
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+
+    const ChemicalMixture<CoeffType>& mixture = _reaction_set.chemical_mixture();
+
+    os << "// Generated by antioch_codegen, do not edit." << std::endl
+       << "//" << std::endl
+       << "// Species:";
+    for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+      os << " " << mixture.chemical_species()[s]->species();
+    os << std::endl << std::endl
+       << "#ifndef " << guard << std::endl
+       << "#define " << guard << std::endl << std::endl
+       << "#include <cmath>" << std::endl << std::endl
+       << "class " << name << std::endl
+       << "{" << std::endl
+       << "public:" << std::endl << std::endl
+       << "  static const unsigned int n_species = " << _reaction_set.n_species() << ";" << std::endl << std::endl
+       << "  static const unsigned int n_reactions = " << _reaction_set.n_reactions() << ";" << std::endl << std::endl;
+
+    this->write_thermo(os, false);
+    this->write_thermo(os, true);
+    this->write_mass_sources(os, false);
+    this->write_mass_sources(os, true);
+
+    os << "};" << std::endl << std::endl
+       << "#endif // " << guard << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_thermo( std::ostream& os, bool derivative ) const
+  {
+    const ChemicalMixture<CoeffType>& mixture = _reaction_set.chemical_mixture();
+    const std::string output = derivative ? "dh_RT_minus_s_R_dT" : "h_RT_minus_s_R";
+
+    // species sharing their temperature intervals share the branches
+    std::vector<std::vector<CoeffType> > temperatures;
+    std::vector<std::vector<unsigned int> > species;
+    for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+      {
+        const std::vector<CoeffType>& temps = _thermo_mixture.curve_fit(s).temperatures();
+        const unsigned int g = std::find(temperatures.begin(), temperatures.end(), temps) - temperatures.begin();
+        if(g == temperatures.size())
+          {
+            temperatures.push_back(temps);
+            species.push_back(std::vector<unsigned int>());
+          }
+        species[g].push_back(s);
+      }
+
+    std::ostringstream body;
+    for(unsigned int g = 0; g < species.size(); g++)
+      {
+        const unsigned int n_intervals = _thermo_mixture.curve_fit(species[g][0]).n_intervals();
+        for(unsigned int i = 0; i < n_intervals; i++)
+          {
+            std::string indent = _indent;
+            if(n_intervals > 1)
+              {
+                if(i == 0)
+                  body << _indent << "if( T < " << literal(temperatures[g][1]) << " )" << std::endl;
+                else if(i + 1 < n_intervals)
+                  body << _indent << "else if( T < " << literal(temperatures[g][i+1]) << " )" << std::endl;
+                else
+                  body << _indent << "else" << std::endl;
+                body << _indent << "  {" << std::endl;
+                indent += "    ";
+              }
+
+            for(unsigned int k = 0; k < species[g].size(); k++)
+              {
+                const unsigned int s = species[g][k];
+                body << indent << output << "[" << s << "] = "
+                     << (derivative ? dh_RT_minus_s_R_dT(_thermo_mixture.curve_fit(s), i) :
+                                      h_RT_minus_s_R(_thermo_mixture.curve_fit(s), i))
+                     << "; // " << mixture.chemical_species()[s]->species() << std::endl;
+              }
+
+            if(n_intervals > 1)
+              body << _indent << "  }" << std::endl;
+          }
+      }
+
+    os << "  template <typename StateType, typename VectorStateType>" << std::endl
+       << "  static void " << output << "( const StateType& T, VectorStateType& " << output << " )" << std::endl
+       << "  {" << std::endl
+       << _indent << "using std::log;" << std::endl << std::endl;
+    this->write_body(os, body.str(), false);
+    os << "  }" << std::endl << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_mass_sources( std::ostream& os, bool derivs ) const
+  {
+    const ChemicalMixture<CoeffType>& mixture = _reaction_set.chemical_mixture();
+    const StoichiometricMatrix<CoeffType>& nu = _reaction_set.stoichiometric_matrix();
+    const unsigned int n_species = _reaction_set.n_species();
+    const unsigned int n_reactions = _reaction_set.n_reactions();
+
+    std::ostringstream body;
+    for(unsigned int rxn = 0; rxn < n_reactions; rxn++)
+      this->write_rate_of_progress(body, rxn, derivs);
+
+    // mass sources, nu * R in mass units
+    for(unsigned int s = 0; s < n_species; s++)
+      {
+        std::string sum, dsum_dT;
+        for(unsigned int rxn = 0; rxn < n_reactions; rxn++)
+          {
+            std::ostringstream r;
+            r << rxn;
+            add_term(sum, nu(s,rxn), "R_" + r.str());
+            add_term(dsum_dT, nu(s,rxn), "dR_" + r.str() + "_dT");
+          }
+
+        body << _indent << "mass_sources[" << s << "] = ";
+        if(sum.empty())
+          body << sum_or_zero(sum);
+        else
+          body << literal(mixture.M(s)) << "*(" << sum << ")";
+        body << "; // " << mixture.chemical_species()[s]->species() << std::endl;
+
+        if(derivs)
+          {
+            body << _indent << "dmass_dT[" << s << "] = ";
+            if(dsum_dT.empty())
+              body << sum_or_zero(dsum_dT);
+            else
+              body << literal(mixture.M(s)) << "*(" << dsum_dT << ")";
+            body << ";" << std::endl;
+          }
+      }
+
+    if(derivs)
+      {
+        // dependencies of each rate of progress
+        std::vector<std::vector<CoeffType> > efficiencies(n_reactions);
+        std::vector<std::vector<bool> > direct(n_reactions, std::vector<bool>(n_species,false));
+        for(unsigned int rxn = 0; rxn < n_reactions; rxn++)
+          {
+            this->mixture_efficiencies(rxn, efficiencies[rxn]);
+            for(unsigned int side = 0; side < (_reaction_set.reaction(rxn).reversible() ? 2 : 1); side++)
+              {
+                std::vector<std::pair<unsigned int,CoeffType> > orders;
+                this->species_orders(rxn, side == 0, orders);
+                for(unsigned int i = 0; i < orders.size(); i++)
+                  direct[rxn][orders[i].first] = true;
+              }
+          }
+
+        body << std::endl;
+        for(unsigned int s = 0; s < n_species; s++)
+          {
+            for(unsigned int t = 0; t < n_species; t++)
+              {
+                std::string sum;
+                for(unsigned int rxn = 0; rxn < n_reactions; rxn++)
+                  {
+                    if(nu(s,rxn) == 0)
+                      continue;
+
+                    std::ostringstream r;
+                    r << rxn;
+                    add_term(sum, nu(s,rxn) * efficiencies[rxn][t], "dR_" + r.str() + "_dM");
+                    if(direct[rxn][t])
+                      {
+                        std::ostringstream dR;
+                        dR << "dR_" << rxn << "_dc" << t;
+                        add_term(sum, nu(s,rxn), dR.str());
+                      }
+                  }
+
+                body << _indent << "dmass_drho_s[" << s << "][" << t << "] = ";
+                if(sum.empty())
+                  body << sum_or_zero(sum);
+                else
+                  body << literal(mixture.M(s)/mixture.M(t)) << "*(" << sum << ")";
+                body << ";" << std::endl;
+              }
+          }
+      }
+
+    if(derivs)
+      os << "  template <typename StateType, typename VectorStateType, typename MatrixStateType>" << std::endl
+         << "  static void compute_mass_sources_and_derivs( const StateType& T," << std::endl
+         << "                                               const VectorStateType& molar_densities," << std::endl
+         << "                                               const VectorStateType& h_RT_minus_s_R," << std::endl
+         << "                                               const VectorStateType& dh_RT_minus_s_R_dT," << std::endl
+         << "                                               VectorStateType& mass_sources," << std::endl
+         << "                                               VectorStateType& dmass_dT," << std::endl
+         << "                                               MatrixStateType& dmass_drho_s )" << std::endl;
+    else
+      os << "  template <typename StateType, typename VectorStateType>" << std::endl
+         << "  static void compute_mass_sources( const StateType& T," << std::endl
+         << "                                    const VectorStateType& molar_densities," << std::endl
+         << "                                    const VectorStateType& h_RT_minus_s_R," << std::endl
+         << "                                    VectorStateType& mass_sources )" << std::endl;
+
+    os << "  {" << std::endl
+       << _indent << "using std::exp;" << std::endl
+       << _indent << "using std::log;" << std::endl
+       << _indent << "using std::pow;" << std::endl << std::endl;
+    this->write_body(os, body.str(), derivs);
+    os << "  }" << std::endl << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_rate_of_progress( std::ostream& os, unsigned int rxn, bool derivs ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+    const StoichiometricMatrix<CoeffType>& nu = _reaction_set.stoichiometric_matrix();
+
+    std::ostringstream r;
+    r << rxn;
+    const std::string R = "R_" + r.str();
+
+    os << _indent << "// " << reaction.equation() << std::endl;
+
+    this->write_forward_rate_coefficient(os, rxn, derivs);
+
+    const std::string kf = "kf_" + r.str();
+    const std::string kb = "kb_" + r.str();
+    const std::string invKeq = "invKeq_" + r.str();
+    const bool has_mixture = (reaction.type() != ReactionType::ELEMENTARY &&
+                              reaction.type() != ReactionType::DUPLICATE);
+
+    std::vector<std::pair<unsigned int,CoeffType> > reactants, products;
+    this->species_orders(rxn, true, reactants);
+    this->species_orders(rxn, false, products);
+
+    std::vector<std::string> forward, backward;
+    concentrations_product(reactants, _reaction_set.n_species(), forward);
+    concentrations_product(products, _reaction_set.n_species(), backward);
+
+    if(reaction.reversible())
+      {
+        // 1/K = (P0/RT)^-gamma exp(sum_s nu_s (h/RT - s/R)_s)
+        std::string exponent, dlnKeq_dT;
+        add_term(exponent, -CoeffType(reaction.gamma()), "lnP0_RT");
+        add_term(dlnKeq_dT, CoeffType(reaction.gamma()), "invT");
+        for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+          {
+            std::ostringstream g, dg;
+            g << "g" << s;
+            dg << "dg" << s;
+            add_term(exponent, nu(s,rxn), g.str());
+            add_term(dlnKeq_dT, nu(s,rxn), dg.str());
+          }
+
+        os << _indent << "const StateType " << invKeq << " = exp(" << sum_or_zero(exponent) << ");" << std::endl
+           << _indent << "const StateType " << kb << " = " << kf << "*" << invKeq << ";" << std::endl;
+        if(derivs)
+          os << _indent << "const StateType d" << kb << "_dT = (d" << kf << "_dT + " << kf << "*("
+             << sum_or_zero(dlnKeq_dT) << "))*" << invKeq << ";" << std::endl;
+
+        std::vector<std::string> kf_forward(1,kf), kb_backward(1,kb);
+        kf_forward.insert(kf_forward.end(), forward.begin(), forward.end());
+        kb_backward.insert(kb_backward.end(), backward.begin(), backward.end());
+        os << _indent << "const StateType " << R << " = " << product(kf_forward) << " - " << product(kb_backward) << ";" << std::endl;
+
+        if(derivs)
+          {
+            kf_forward[0] = "d" + kf + "_dT";
+            kb_backward[0] = "d" + kb + "_dT";
+            os << _indent << "const StateType d" << R << "_dT = " << product(kf_forward) << " - " << product(kb_backward) << ";" << std::endl;
+
+            if(has_mixture)
+              {
+                std::vector<std::string> invKeq_backward(1,invKeq);
+                invKeq_backward.insert(invKeq_backward.end(), backward.begin(), backward.end());
+                os << _indent << "const StateType d" << R << "_dM = d" << kf << "_dM*("
+                   << product(forward) << " - " << product(invKeq_backward) << ");" << std::endl;
+              }
+          }
+      }
+    else
+      {
+        std::vector<std::string> kf_forward(1,kf);
+        kf_forward.insert(kf_forward.end(), forward.begin(), forward.end());
+        os << _indent << "const StateType " << R << " = " << product(kf_forward) << ";" << std::endl;
+
+        if(derivs)
+          {
+            kf_forward[0] = "d" + kf + "_dT";
+            os << _indent << "const StateType d" << R << "_dT = " << product(kf_forward) << ";" << std::endl;
+            if(has_mixture)
+              os << _indent << "const StateType d" << R << "_dM = d" << kf << "_dM*" << product(forward) << ";" << std::endl;
+          }
+      }
+
+    if(derivs)
+      {
+        // direct dependencies on the reactants and products
+        std::vector<unsigned int> species;
+        for(unsigned int i = 0; i < reactants.size(); i++)
+          species.push_back(reactants[i].first);
+        if(reaction.reversible())
+          for(unsigned int i = 0; i < products.size(); i++)
+            species.push_back(products[i].first);
+        std::sort(species.begin(), species.end());
+        species.erase(std::unique(species.begin(), species.end()), species.end());
+
+        for(unsigned int i = 0; i < species.size(); i++)
+          {
+            const unsigned int s = species[i];
+            std::vector<std::string> dforward(1,kf), dbackward(1,kb);
+            const bool has_forward = concentrations_product(reactants, s, dforward);
+            const bool has_backward = reaction.reversible() && concentrations_product(products, s, dbackward);
+
+            os << _indent << "const StateType d" << R << "_dc" << s << " = ";
+            if(has_forward)
+              os << product(dforward);
+            if(has_backward)
+              os << (has_forward ? " - " : "-") << product(dbackward);
+            os << ";" << std::endl;
+          }
+      }
+
+    os << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_forward_rate_coefficient( std::ostream& os, unsigned int rxn, bool derivs ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    std::ostringstream rs;
+    rs << rxn;
+    const std::string r = rs.str();
+    const std::string kf = "kf_" + r;
+
+    switch(reaction.type())
+      {
+      case(ReactionType::ELEMENTARY):
+      case(ReactionType::DUPLICATE):
+        {
+          if(reaction.n_rate_constants() == 1)
+            {
+              this->write_rate_constant(os, reaction.forward_rate(0), kf, derivs);
+              break;
+            }
+
+          // duplicate, sum of the rate constants
+          std::string sum, dsum_dT;
+          for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+            {
+              std::ostringstream k;
+              k << "k_" << r << "_" << ir;
+              this->write_rate_constant(os, reaction.forward_rate(ir), k.str(), derivs);
+              add_term(sum, 1, k.str());
+              add_term(dsum_dT, 1, "d" + k.str() + "_dT");
+            }
+          os << _indent << "const StateType " << kf << " = " << sum << ";" << std::endl;
+          if(derivs)
+            os << _indent << "const StateType d" << kf << "_dT = " << dsum_dT << ";" << std::endl;
+        }
+        break;
+
+      case(ReactionType::THREE_BODY):
+        {
+          this->write_rate_constant(os, reaction.forward_rate(0), "k_" + r, derivs);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+      case(ReactionType::TROE_FALLOFF):
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          antioch_assert_equal_to(reaction.n_rate_constants(), 2);
+          this->write_rate_constant(os, reaction.forward_rate(0), "k0_" + r, derivs);
+          this->write_rate_constant(os, reaction.forward_rate(1), "kinf_" + r, derivs);
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch(reaction.type())
+
+    if(reaction.type() == ReactionType::ELEMENTARY || reaction.type() == ReactionType::DUPLICATE)
+      return;
+
+    // [M] = sum_s c_s + sum_s (epsilon_s - 1) c_s
+    std::vector<CoeffType> efficiencies;
+    this->mixture_efficiencies(rxn, efficiencies);
+    std::string M = "M";
+    for(unsigned int s = 0; s < efficiencies.size(); s++)
+      {
+        std::ostringstream c;
+        c << "c" << s;
+        add_term(M, efficiencies[s] - 1, c.str());
+      }
+    os << _indent << "const StateType M_" << r << " = " << M << ";" << std::endl;
+
+    if(reaction.type() == ReactionType::THREE_BODY)
+      {
+        os << _indent << "const StateType " << kf << " = k_" << r << "*M_" << r << ";" << std::endl;
+        if(derivs)
+          os << _indent << "const StateType d" << kf << "_dT = dk_" << r << "_dT*M_" << r << ";" << std::endl
+             << _indent << "const StateType d" << kf << "_dM = k_" << r << ";" << std::endl;
+        return;
+      }
+
+    // k = kinf Pr/(1 + Pr) F, Pr = [M] k0/kinf
+    const bool troe = (reaction.type() == ReactionType::TROE_FALLOFF ||
+                       reaction.type() == ReactionType::TROE_FALLOFF_THREE_BODY);
+    const std::string L = troe ? "L_" + r : kf;
+
+    os << _indent << "const StateType Pr_" << r << " = M_" << r << "*k0_" << r << "/kinf_" << r << ";" << std::endl
+       << _indent << "const StateType G_" << r << " = 1/(1 + Pr_" << r << ");" << std::endl
+       << _indent << "const StateType " << L << " = kinf_" << r << "*Pr_" << r << "*G_" << r << ";" << std::endl;
+    if(derivs)
+      os << _indent << "const StateType d" << L << "_dT = (dk0_" << r << "_dT*M_" << r << " + dkinf_" << r << "_dT*Pr_" << r << "*Pr_" << r
+         << ")*G_" << r << "*G_" << r << ";" << std::endl
+         << _indent << "const StateType d" << L << "_dM = k0_" << r << "*G_" << r << "*G_" << r << ";" << std::endl;
+
+    if(troe)
+      {
+        const TroeFalloff<CoeffType>& falloff =
+          (reaction.type() == ReactionType::TROE_FALLOFF)?
+          static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F():
+          static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F();
+
+        this->write_troe_falloff(os, falloff, r, derivs);
+
+        os << _indent << "const StateType " << kf << " = " << L << "*F_" << r << ";" << std::endl;
+        if(derivs)
+          os << _indent << "const StateType d" << kf << "_dT = d" << L << "_dT*F_" << r << " + " << L << "*dF_" << r << "_dT;" << std::endl
+             << _indent << "const StateType d" << kf << "_dM = d" << L << "_dM*F_" << r << " + " << L << "*dF_" << r << "_dM;" << std::endl;
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_rate_constant( std::ostream& os, const KineticsType<CoeffType>& rate,
+                                                                      const std::string& k, bool derivs ) const
+  {
+    CoeffType Cf, eta, Ea, D;
+    CompiledReactionSet<CoeffType>::rate_parameters(rate, Cf, eta, Ea, D);
+
+    // k = Cf exp(eta lnT - Ea/T + D T)
+    std::string exponent, dlnk_dT;
+    add_term(exponent, eta, "lnT");
+    add_term(exponent, -Ea, "invT");
+    add_term(exponent, D, "T");
+    add_term(dlnk_dT, eta, "invT");
+    add_term(dlnk_dT, Ea, "invT2");
+    add_term(dlnk_dT, D, "");
+
+    os << _indent << "const StateType " << k << " = " << literal(Cf);
+    if(!exponent.empty())
+      os << "*exp(" << exponent << ")";
+    os << ";" << std::endl;
+
+    if(derivs)
+      os << _indent << "const StateType d" << k << "_dT = "
+         << (dlnk_dT.empty() ? sum_or_zero(dlnk_dT) : k + "*(" + dlnk_dT + ")") << ";" << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_troe_falloff( std::ostream& os, const TroeFalloff<CoeffType>& falloff,
+                                                                     const std::string& r, bool derivs ) const
+  {
+    // Fcent = (1-alpha) exp(-T/T3) + alpha exp(-T/T1) + exp(-T2/T)
+    const CoeffType alpha = falloff.get_alpha();
+    const bool has_T2 = (falloff.get_T2() != std::numeric_limits<CoeffType>::max());
+
+    std::string Fcent, dFcent_dT;
+    add_term(Fcent, 1 - alpha, "exp(" + literal(-1/falloff.get_T3()) + "*T)");
+    add_term(Fcent, alpha, "exp(" + literal(-1/falloff.get_T1()) + "*T)");
+    add_term(dFcent_dT, (alpha - 1)/falloff.get_T3(), "exp(" + literal(-1/falloff.get_T3()) + "*T)");
+    add_term(dFcent_dT, -alpha/falloff.get_T1(), "exp(" + literal(-1/falloff.get_T1()) + "*T)");
+    if(has_T2)
+      {
+        add_term(Fcent, 1, "exp(" + literal(-falloff.get_T2()) + "*invT)");
+        add_term(dFcent_dT, falloff.get_T2(), "invT2*exp(" + literal(-falloff.get_T2()) + "*invT)");
+      }
+
+    // c = -0.4 - 0.67 log10(Fcent), n = 0.75 - 1.27 log10(Fcent)
+    // log(F) = log(Fcent)/(1 + x^2), x = (log10(Pr) + c)/(n - 0.14 (log10(Pr) + c))
+    const CoeffType log10_to_log = Constants::log10_to_log<CoeffType>();
+    const CoeffType c_coeff = CoeffType(0.67L) * log10_to_log;
+    const CoeffType n_coeff = CoeffType(1.27L) * log10_to_log;
+    const CoeffType d = CoeffType(0.14L);
+
+    os << _indent << "const StateType Fcent_" << r << " = " << sum_or_zero(Fcent) << ";" << std::endl
+       << _indent << "const StateType logFcent_" << r << " = log(Fcent_" << r << ");" << std::endl
+       << _indent << "const StateType c_" << r << " = " << literal(-CoeffType(0.4L)) << " - " << literal(c_coeff) << "*logFcent_" << r << ";" << std::endl
+       << _indent << "const StateType n_" << r << " = " << literal(CoeffType(0.75L)) << " - " << literal(n_coeff) << "*logFcent_" << r << ";" << std::endl
+       << _indent << "const StateType log10Pr_c_" << r << " = " << literal(log10_to_log) << "*log(Pr_" << r << ") + c_" << r << ";" << std::endl
+       << _indent << "const StateType den_" << r << " = n_" << r << " - " << literal(d) << "*log10Pr_c_" << r << ";" << std::endl
+       << _indent << "const StateType x_" << r << " = log10Pr_c_" << r << "/den_" << r << ";" << std::endl
+       << _indent << "const StateType logF_" << r << " = logFcent_" << r << "/(1 + x_" << r << "*x_" << r << ");" << std::endl
+       << _indent << "const StateType F_" << r << " = exp(logF_" << r << ");" << std::endl;
+
+    // derivatives, as in TroeFalloff::F_and_M_derivative()
+    if(derivs)
+      os << _indent << "const StateType dFcent_" << r << "_dT = " << sum_or_zero(dFcent_dT) << ";" << std::endl
+         << _indent << "const StateType dlogFcent_" << r << "_dT = dFcent_" << r << "_dT/Fcent_" << r << ";" << std::endl
+         << _indent << "const StateType dlog10Pr_c_" << r << "_dT = " << literal(log10_to_log) << "*(dk0_" << r << "_dT/k0_" << r
+         << " - dkinf_" << r << "_dT/kinf_" << r << ") - " << literal(c_coeff) << "*dlogFcent_" << r << "_dT;" << std::endl
+         << _indent << "const StateType dlogF_" << r << "_dT = logF_" << r << "*(" << literal(log10_to_log) << "*dlogFcent_" << r << "_dT/Fcent_" << r
+         << " - 2*x_" << r << "*x_" << r << "*(dlog10Pr_c_" << r << "_dT/log10Pr_c_" << r
+         << " - (" << literal(-n_coeff) << "*dlogFcent_" << r << "_dT - " << literal(d) << "*dlog10Pr_c_" << r << "_dT)/den_" << r
+         << ")/(1 + x_" << r << "*x_" << r << "));" << std::endl
+         << _indent << "const StateType dF_" << r << "_dT = F_" << r << "*dlogF_" << r << "_dT;" << std::endl
+         << _indent << "const StateType dF_" << r << "_dM = -F_" << r << "*logF_" << r << "*logF_" << r << "/logFcent_" << r
+         << "*" << literal(log10_to_log) << "/M_" << r << "*(1 - 1/den_" << r << ")*log10Pr_c_" << r << ";" << std::endl;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::mixture_efficiencies( unsigned int rxn, std::vector<CoeffType>& efficiencies ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    switch(reaction.type())
+      {
+      case(ReactionType::THREE_BODY):
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          efficiencies.resize(_reaction_set.n_species());
+          for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+            efficiencies[s] = reaction.efficiency(s);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+      case(ReactionType::TROE_FALLOFF):
+        {
+          efficiencies.assign(_reaction_set.n_species(), 1);
+        }
+        break;
+
+      default:
+        {
+          efficiencies.assign(_reaction_set.n_species(), 0);
+        }
+      } // switch(reaction.type())
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::species_orders( unsigned int rxn, bool reactants,
+                                                                 std::vector<std::pair<unsigned int,CoeffType> >& orders ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    orders.clear();
+    const unsigned int n = reactants ? reaction.n_reactants() : reaction.n_products();
+    for(unsigned int i = 0; i < n; i++)
+      {
+        const unsigned int s = reactants ? reaction.reactant_id(i) : reaction.product_id(i);
+        const CoeffType order = reactants ? reaction.reactant_partial_order(i) : reaction.product_partial_order(i);
+
+        unsigned int j = 0;
+        while(j < orders.size() && orders[j].first != s)
+          j++;
+        if(j == orders.size())
+          orders.push_back(std::make_pair(s,CoeffType(0)));
+        orders[j].second += order;
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  bool KineticsCodeGenerator<CoeffType,NASAFit>::concentrations_product( const std::vector<std::pair<unsigned int,CoeffType> >& orders,
+                                                                         unsigned int species,
+                                                                         std::vector<std::string>& factors )
+  {
+    bool found = false;
+
+    for(unsigned int i = 0; i < orders.size(); i++)
+      {
+        std::ostringstream c;
+        c << "c" << orders[i].first;
+        CoeffType order = orders[i].second;
+
+        if(orders[i].first == species)
+          {
+            // order c^(order-1)
+            if(order != 1)
+              factors.push_back(literal(order));
+            order -= 1;
+            found = true;
+          }
+
+        if(order == 0)
+          continue;
+
+        const int n = static_cast<int>(order);
+        if(CoeffType(n) == order && n > 0 && n <= 4)
+          for(int p = 0; p < n; p++)
+            factors.push_back(c.str());
+        else
+          factors.push_back("pow(" + c.str() + ", " + literal(order) + ")");
+      }
+
+    return found;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::h_RT_minus_s_R( const NASA7CurveFit<CoeffType>& fit, unsigned int interval )
+  {
+    /* h/RT =  a[0]     + a[1]*T/2. + a[2]*T2/3. + a[3]*T3/4. + a[4]*T4/5. + a[5]/T,
+       s/R  =  a[0]*lnT + a[1]*T    + a[2]*T2/2. + a[3]*T3/3. + a[4]*T4/4. + a[6]   */
+    const CoeffType* a = fit.coefficients(interval);
+
+    std::vector<CoeffType> poly(5);
+    poly[0] = a[0] - a[6];
+    poly[1] = -a[1]/2;
+    poly[2] = -a[2]/6;
+    poly[3] = -a[3]/12;
+    poly[4] = -a[4]/20;
+
+    std::string sum;
+    add_term(sum, a[5], "invT");
+    add_term(sum, -a[0], "lnT");
+    add_sum(sum, horner(poly,"T"));
+
+    return sum_or_zero(sum);
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::dh_RT_minus_s_R_dT( const NASA7CurveFit<CoeffType>& fit, unsigned int interval )
+  {
+    const CoeffType* a = fit.coefficients(interval);
+
+    std::vector<CoeffType> poly(4);
+    poly[0] = -a[1]/2;
+    poly[1] = -a[2]/3;
+    poly[2] = -a[3]/4;
+    poly[3] = -a[4]/5;
+
+    std::string sum;
+    add_term(sum, -a[5], "invT2");
+    add_term(sum, -a[0], "invT");
+    add_sum(sum, horner(poly,"T"));
+
+    return sum_or_zero(sum);
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::h_RT_minus_s_R( const NASA9CurveFit<CoeffType>& fit, unsigned int interval )
+  {
+    /* h/RT = -a[0]/T2    + a[1]*lnT/T + a[2]     + a[3]*T/2. + a[4]*T2/3. + a[5]*T3/4. + a[6]*T4/5. + a[7]/T,
+       s/R  = -a[0]/T2/2. - a[1]/T     + a[2]*lnT + a[3]*T    + a[4]*T2/2. + a[5]*T3/3. + a[6]*T4/4. + a[8]   */
+    const CoeffType* a = fit.coefficients(interval);
+
+    std::vector<CoeffType> poly(5);
+    poly[0] = a[2] - a[8];
+    poly[1] = -a[3]/2;
+    poly[2] = -a[4]/6;
+    poly[3] = -a[5]/12;
+    poly[4] = -a[6]/20;
+
+    std::string sum;
+    add_term(sum, -a[0]/2, "invT2");
+    add_term(sum, a[1] + a[7], "invT");
+    add_term(sum, a[1], "lnT*invT");
+    add_term(sum, -a[2], "lnT");
+    add_sum(sum, horner(poly,"T"));
+
+    return sum_or_zero(sum);
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::dh_RT_minus_s_R_dT( const NASA9CurveFit<CoeffType>& fit, unsigned int interval )
+  {
+    const CoeffType* a = fit.coefficients(interval);
+
+    std::vector<CoeffType> poly(4);
+    poly[0] = -a[3]/2;
+    poly[1] = -a[4]/3;
+    poly[2] = -a[5]/4;
+    poly[3] = -a[6]/5;
+
+    std::string sum;
+    add_term(sum, a[0], "invT3");
+    add_term(sum, -a[7], "invT2");
+    add_term(sum, -a[1], "lnT*invT2");
+    add_term(sum, -a[2], "invT");
+    add_sum(sum, horner(poly,"T"));
+
+    return sum_or_zero(sum);
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::literal( const CoeffType& x )
+  {
+    std::ostringstream os;
+
+    // small integers are exact in any floating point type
+    if(std::abs(x) < CoeffType(1e6) && x == CoeffType(static_cast<int>(x)))
+      {
+        os << "StateType(" << static_cast<int>(x) << ")";
+        return os.str();
+      }
+
+    os << std::setprecision(std::numeric_limits<CoeffType>::max_digits10) << x;
+    std::string value = os.str();
+    if(value.find_first_of(".e") == std::string::npos)
+      value += ".";
+
+    return "StateType(" + value + "L)";
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::add_term( std::string& sum, const CoeffType& coeff, const std::string& expr )
+  {
+    if(coeff == 0)
+      return;
+
+    if(sum.empty())
+      sum = (coeff < 0) ? "-" : "";
+    else
+      sum += (coeff < 0) ? " - " : " + ";
+
+    const CoeffType abs_coeff = (coeff < 0) ? -coeff : coeff;
+    if(expr.empty())
+      sum += literal(abs_coeff);
+    else if(abs_coeff == 1)
+      sum += expr;
+    else
+      sum += literal(abs_coeff) + "*" + expr;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::add_sum( std::string& sum, const std::string& expr )
+  {
+    if(expr.empty())
+      return;
+
+    // the leading sign of a generated sum only applies to its first term
+    if(sum.empty())
+      sum = expr;
+    else if(expr[0] == '-')
+      sum += " - " + expr.substr(1);
+    else
+      sum += " + " + expr;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::sum_or_zero( const std::string& sum )
+  {
+    return sum.empty() ? "StateType(0)" : sum;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::horner( const std::vector<CoeffType>& c, const std::string& x )
+  {
+    unsigned int n = c.size();
+    while(n > 0 && c[n-1] == 0)
+      n--;
+
+    std::string poly;
+    for(unsigned int i = n; i > 0; i--)
+      {
+        std::string term;
+        add_term(term, c[i-1], "");
+        if(!poly.empty())
+          {
+            if(term.empty())
+              term = x + "*(" + poly + ")";
+            else
+              term += " + " + x + "*(" + poly + ")";
+          }
+        poly = term;
+      }
+
+    return poly;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  std::string KineticsCodeGenerator<CoeffType,NASAFit>::product( const std::vector<std::string>& factors )
+  {
+    if(factors.empty())
+      return "StateType(1)";
+
+    std::string prod = factors[0];
+    for(unsigned int i = 1; i < factors.size(); i++)
+      prod += "*" + factors[i];
+
+    return prod;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  bool KineticsCodeGenerator<CoeffType,NASAFit>::uses( const std::string& code, const std::string& name )
+  {
+    std::string::size_type pos = code.find(name);
+    while(pos != std::string::npos)
+      {
+        const std::string::size_type end = pos + name.size();
+        const bool starts = (pos == 0 || !(std::isalnum(code[pos-1]) || code[pos-1] == '_'));
+        const bool ends = (end == code.size() || !(std::isalnum(code[end]) || code[end] == '_'));
+        if(starts && ends)
+          return true;
+        pos = code.find(name, pos + 1);
+      }
+
+    return false;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void KineticsCodeGenerator<CoeffType,NASAFit>::write_body( std::ostream& os, const std::string& body, bool derivs ) const
+  {
+    // temperature
+    bool declared = false;
+    if(uses(body,"lnT") || uses(body,"lnP0_RT"))
+      {
+        os << _indent << "const StateType lnT = log(T);" << std::endl;
+        declared = true;
+      }
+    if(uses(body,"invT") || uses(body,"invT2") || uses(body,"invT3"))
+      {
+        os << _indent << "const StateType invT = 1/T;" << std::endl;
+        declared = true;
+      }
+    if(uses(body,"invT2") || uses(body,"invT3"))
+      os << _indent << "const StateType invT2 = invT*invT;" << std::endl;
+    if(uses(body,"invT3"))
+      os << _indent << "const StateType invT3 = invT2*invT;" << std::endl;
+    if(uses(body,"lnP0_RT"))
+      os << _indent << "const StateType lnP0_RT = "
+         << literal(std::log(CoeffType(1.0e5)/Constants::R_universal<CoeffType>())) << " - lnT;" << std::endl;
+    if(declared)
+      os << std::endl;
+
+    // species
+    declared = false;
+    for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+      {
+        std::ostringstream c, g, dg;
+        c << "c" << s;
+        g << "g" << s;
+        dg << "dg" << s;
+        if(uses(body,c.str()) || uses(body,"M"))
+          os << _indent << "const StateType " << c.str() << " = molar_densities[" << s << "];" << std::endl;
+        if(uses(body,g.str()))
+          os << _indent << "const StateType " << g.str() << " = h_RT_minus_s_R[" << s << "];" << std::endl;
+        if(derivs && uses(body,dg.str()))
+          os << _indent << "const StateType " << dg.str() << " = dh_RT_minus_s_R_dT[" << s << "];" << std::endl;
+        declared = true;
+      }
+    if(declared)
+      os << std::endl;
+
+    if(uses(body,"M"))
+      {
+        std::string M;
+        for(unsigned int s = 0; s < _reaction_set.n_species(); s++)
+          {
+            std::ostringstream c;
+            c << "c" << s;
+            add_term(M, 1, c.str());
+          }
+        os << _indent << "const StateType M = " << M << ";" << std::endl << std::endl;
+      }
+
+    os << body;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_KINETICS_CODE_GENERATOR_H
@@ -31,6 +31,7 @@
 #include "antioch/metaprogramming.h"
 #include "antioch/reaction_set.h"
 #include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_workspace.h"
 
 // C++
 #include <vector>
@@ -45,8 +46,11 @@ namespace Antioch
   class ChemicalMixture;
   
   //! Class to handle computing mass source terms for a given ReactionSet.
-  /*! This class preallocates work arrays and so *must* be created within a spawned
-   *  thread, if running in a threaded environment. It takes a reference to an
+  /*! The methods taking a KineticsWorkspace are const: a single evaluator
+   *  can be shared by all the threads, each thread passing its own workspace.
+   *  The methods without a workspace use a workspace owned by the evaluator,
+   *  and so the evaluator *must* be created within a spawned thread, if
+   *  running in a threaded environment. It takes a reference to an
    *  already created ReactionSet, so there's little construction penalty.
    */
   template<typename CoeffType=double, typename StateType=CoeffType>
@@ -73,6 +77,14 @@ namespace Antioch
                                const VectorStateType& molar_densities,
                                const VectorStateType& h_RT_minus_s_R,
                                VectorStateType& mass_sources );
+
+    //! Compute species production/destruction rates per unit volume, in \p workspace
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources( KineticsWorkspace<StateType>& workspace,
+                               const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mass_sources ) const;
     
     //! Compute species production/destruction rate derivatives
     /*! In mass units, e.g. \f$ \frac{\partial \dot{\omega}}{dT}
@@ -86,6 +98,17 @@ namespace Antioch
                                           VectorStateType& dmass_dT,
                                           std::vector<VectorStateType>& dmass_drho_s );
 
+    //! Compute species production/destruction rate derivatives, in \p workspace
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                          const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mass_sources,
+                                          VectorStateType& dmass_dT,
+                                          std::vector<VectorStateType>& dmass_drho_s ) const;
+
     //! Compute species molar production/destruction rates per unit volume
     /*! \f$ \left(mole/sec/m^3\right)\f$ */
     template <typename VectorStateType, typename KC>
@@ -94,6 +117,14 @@ namespace Antioch
                                const VectorStateType& h_RT_minus_s_R,
                                VectorStateType& mole_sources );
 
+    //! Compute species molar production/destruction rates per unit volume, in \p workspace
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources( KineticsWorkspace<StateType>& workspace,
+                               const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mole_sources ) const;
+
     //! Compute species production/destruction rate derivatives
     /*! In mass units, e.g. \f$ \frac{\partial \dot{\omega}}{dT}
       [\left(mole/sec/m^3/K\right)]\f$ */
@@ -106,6 +137,17 @@ namespace Antioch
                                           VectorStateType& dmole_dT,
                                           std::vector<VectorStateType>& dmole_dX_s );
 
+    //! Compute species molar production/destruction rate derivatives, in \p workspace
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                          const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mole_sources,
+                                          VectorStateType& dmole_dT,
+                                          std::vector<VectorStateType>& dmole_dX_s ) const;
+
     unsigned int n_species() const;
 
     unsigned int n_reactions() const;
@@ -116,11 +158,8 @@ namespace Antioch
 
     const ChemicalMixture<CoeffType>& _chem_mixture;
 
-    std::vector<StateType> _net_reaction_rates;
-
-    std::vector<StateType> _dnet_rate_dT;
-
-    std::vector<std::vector<StateType> > _dnet_rate_dX_s;
+    //! used by the methods without an explicit workspace
+    KineticsWorkspace<StateType> _workspace;
   };
 
   /* ------------------------- Inline Functions -------------------------*/
@@ -153,16 +192,8 @@ namespace Antioch
     const StateType& example )
     : _reaction_set( reaction_set ),
       _chem_mixture( reaction_set.chemical_mixture() ),
-      _net_reaction_rates( reaction_set.n_reactions(), example ),
-      _dnet_rate_dT( reaction_set.n_reactions(), example ),
-      _dnet_rate_dX_s( reaction_set.n_reactions() )
+      _workspace( reaction_set, example )
   {
-
-    for( unsigned int r = 0; r < this->n_reactions(); r++ )
-      {
-        _dnet_rate_dX_s[r].resize( reaction_set.n_species(), example );
-      }
-
     return;
   }
 
@@ -182,6 +213,20 @@ namespace Antioch
                                                                      const VectorStateType& h_RT_minus_s_R,
                                                                      VectorStateType& mole_sources )
   {
+    this->compute_mole_sources( _workspace, conditions, molar_densities, h_RT_minus_s_R, mole_sources );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources( KineticsWorkspace<StateType>& workspace,
+                                                                     const KC& conditions,
+                                                                     const VectorStateType& molar_densities,
+                                                                     const VectorStateType& h_RT_minus_s_R,
+                                                                     VectorStateType& mole_sources ) const
+  {
+    std::vector<StateType>& net_reaction_rates = workspace.net_reaction_rates();
+
     //! \todo Make these assertions vector-compatible
     // antioch_assert_greater(T, 0.0);
     antioch_assert_equal_to( molar_densities.size(), this->n_species() );
@@ -189,47 +234,22 @@ namespace Antioch
     antioch_assert_equal_to( mole_sources.size(), this->n_species() );
 
     /*! \todo Do we need to really initialize this? */
-    Antioch::set_zero(_net_reaction_rates);
-
-    Antioch::set_zero(mole_sources);
+    Antioch::set_zero(net_reaction_rates);
 
     typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
                 kinetics_conditions(conditions);
     // compute the requisite reaction rates
     this->_reaction_set.compute_reaction_rates( kinetics_conditions, molar_densities,
-                                                h_RT_minus_s_R, _net_reaction_rates );
+                                                h_RT_minus_s_R, net_reaction_rates );
 
     // compute the actual mole sources in kmol/sec/m^3
-    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
-      {
-        const Reaction<CoeffType>& reaction = this->_reaction_set.reaction(rxn);
-        const StateType rate = _net_reaction_rates[rxn];
-
-        // We'd *like* to assert that our rates aren't NaN, but if we
-        // have two infinitely-stiff reactions contributing in
-        // opposite directions to the same rate, then NaN is the
-        // correct output, and hopefully our user code has some way to
-        // recover from that.
-//        antioch_assert(!has_nan(rate));
-        
-        // reactant contributions
-        for (unsigned int r = 0; r < reaction.n_reactants(); r++)
-          {
-            const unsigned int r_id = reaction.reactant_id(r);
-            const unsigned int r_stoich = reaction.reactant_stoichiometric_coefficient(r);
-            
-            mole_sources[r_id] -= (static_cast<CoeffType>(r_stoich)*rate);
-          }
-        
-        // product contributions
-        for (unsigned int p=0; p < reaction.n_products(); p++)
-          {
-            const unsigned int p_id = reaction.product_id(p);
-            const unsigned int p_stoich = reaction.product_stoichiometric_coefficient(p);
-            
-            mole_sources[p_id] += (static_cast<CoeffType>(p_stoich)*rate);
-          }
-      }
+    //
+    // We'd *like* to assert that our rates aren't NaN, but if we
+    // have two infinitely-stiff reactions contributing in
+    // opposite directions to the same rate, then NaN is the
+    // correct output, and hopefully our user code has some way to
+    // recover from that.
+    this->_reaction_set.stoichiometric_matrix().multiply( net_reaction_rates, mole_sources );
 
     return;
   }
@@ -242,9 +262,21 @@ namespace Antioch
                                                                      const VectorStateType& molar_densities,
                                                                      const VectorStateType& h_RT_minus_s_R,
                                                                      VectorStateType& mass_sources )
+  {
+    this->compute_mass_sources( _workspace, conditions, molar_densities, h_RT_minus_s_R, mass_sources );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources( KineticsWorkspace<StateType>& workspace,
+                                                                     const KC& conditions,
+                                                                     const VectorStateType& molar_densities,
+                                                                     const VectorStateType& h_RT_minus_s_R,
+                                                                     VectorStateType& mass_sources ) const
   {
     // Quantities asserted in compute_mole_sources call
-    this->compute_mole_sources( conditions, molar_densities, h_RT_minus_s_R, mass_sources );
+    this->compute_mole_sources( workspace, conditions, molar_densities, h_RT_minus_s_R, mass_sources );
 
     // finally scale by molar mass
     for (unsigned int s=0; s < this->n_species(); s++)
@@ -265,6 +297,22 @@ namespace Antioch
                                                                                 VectorStateType& mole_sources,
                                                                                 VectorStateType& dmole_dT,
                                                                                 std::vector<VectorStateType>& dmole_dX_s )
+  {
+    this->compute_mole_sources_and_derivs( _workspace, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           mole_sources, dmole_dT, dmole_dX_s );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                                                                const KC& conditions,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                VectorStateType& mole_sources,
+                                                                                VectorStateType& dmole_dT,
+                                                                                std::vector<VectorStateType>& dmole_dX_s ) const
   {
     //! \todo Make these assertions vector-compatible
     // antioch_assert_greater(T, 0.0);
@@ -282,21 +330,18 @@ namespace Antioch
       }
 #endif
     
-    /*! \todo Do we need to really initialize these? */
-    Antioch::set_zero(_net_reaction_rates);
-    Antioch::set_zero(_dnet_rate_dT);
+    std::vector<StateType>& net_reaction_rates = workspace.net_reaction_rates();
+    std::vector<StateType>& dnet_rate_dT = workspace.dnet_rate_dT();
+    std::vector<std::vector<StateType> >& dnet_rate_dX_s = workspace.dnet_rate_dX_s();
 
-    Antioch::set_zero(mole_sources);
-    Antioch::set_zero(dmole_dT);
-    for (unsigned int s=0; s < this->n_species(); s++)
-      {
-        Antioch::set_zero(dmole_dX_s[s]);
-      }
+    /*! \todo Do we need to really initialize these? */
+    Antioch::set_zero(net_reaction_rates);
+    Antioch::set_zero(dnet_rate_dT);
 
     for (unsigned int rxn=0; rxn < this->n_reactions(); rxn++)
       {
         /*! \todo Do we need to really initialize this? */
-        Antioch::set_zero(_dnet_rate_dX_s[rxn]);
+        Antioch::set_zero(dnet_rate_dX_s[rxn]);
       }
 
     typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
@@ -304,56 +349,16 @@ namespace Antioch
     // compute the requisite reaction rates
     this->_reaction_set.compute_reaction_rates_and_derivs( kinetics_conditions, molar_densities, 
                                                            h_RT_minus_s_R, dh_RT_minus_s_R_dT,
-                                                           _net_reaction_rates,
-                                                           _dnet_rate_dT, 
-                                                           _dnet_rate_dX_s );
-    // compute the actual mole sources in kmol/sec/m^3
-    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
-      {
+                                                           net_reaction_rates,
+                                                           dnet_rate_dT,
+                                                           dnet_rate_dX_s );
 
-        const Reaction<CoeffType>& reaction = this->_reaction_set.reaction(rxn);
-
-        /*! \todo Are these going to get optimized out? Should we remove them? */
-        const StateType rate = _net_reaction_rates[rxn];
-        const StateType drate_dT = _dnet_rate_dT[rxn];
-        const VectorStateType drate_dX_s = _dnet_rate_dX_s[rxn];
-
-        // reactant contributions
-        for (unsigned int r = 0; r < reaction.n_reactants(); r++)
-          {
-            const unsigned int r_id = reaction.reactant_id(r);
-            const unsigned int r_stoich = reaction.reactant_stoichiometric_coefficient(r);
-            
-            mole_sources[r_id] -= (static_cast<CoeffType>(r_stoich)*rate);
-
-            // d/dT rate contributions
-            dmole_dT[r_id] -= (static_cast<CoeffType>(r_stoich)*drate_dT);
-
-            // d(.m)/dX_s rate contributions
-            for (unsigned int s=0; s < this->n_species(); s++)
-              {
-                dmole_dX_s[r_id][s] -= (static_cast<CoeffType>(r_stoich)*drate_dX_s[s]);
-              }
-          }
-        
-        // product contributions
-        for (unsigned int p=0; p < reaction.n_products(); p++)
-          {
-            const unsigned int p_id = reaction.product_id(p);
-            const unsigned int p_stoich = reaction.product_stoichiometric_coefficient(p);
-            
-            mole_sources[p_id] += (static_cast<CoeffType>(p_stoich)*rate);
-
-            // d/dT rate contributions
-            dmole_dT[p_id] += (static_cast<CoeffType>(p_stoich)*drate_dT);
-
-            // d/dX_s rate contributions
-            for (unsigned int s=0; s < this->n_species(); s++)
-              {
-                dmole_dX_s[p_id][s] += (static_cast<CoeffType>(p_stoich)*drate_dX_s[s]);
-              }
-          }
-      }
+    // compute the actual mole sources in kmol/sec/m^3 and their
+    // temperature and molar densities derivatives
+    const StoichiometricMatrix<CoeffType>& nu = this->_reaction_set.stoichiometric_matrix();
+    nu.multiply( net_reaction_rates, mole_sources );
+    nu.multiply( dnet_rate_dT, dmole_dT );
+    nu.multiply_rows( dnet_rate_dX_s, dmole_dX_s );
 
     return;
   }
@@ -369,9 +374,25 @@ namespace Antioch
                                                                                 VectorStateType& mass_sources,
                                                                                 VectorStateType& dmass_dT,
                                                                                 std::vector<VectorStateType>& dmass_drho_s )
+  {
+    this->compute_mass_sources_and_derivs( _workspace, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           mass_sources, dmass_dT, dmass_drho_s );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( KineticsWorkspace<StateType>& workspace,
+                                                                                const KC& conditions,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                VectorStateType& mass_sources,
+                                                                                VectorStateType& dmass_dT,
+                                                                                std::vector<VectorStateType>& dmass_drho_s ) const
   {
     // Asserts are in compute_mole_sources
-    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+    this->compute_mole_sources_and_derivs( workspace, conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
                                            mass_sources, dmass_dT, dmass_drho_s );
     
     // Convert from mole units to mass units
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_KINETICS_WORKSPACE_H
+#define ANTIOCH_KINETICS_WORKSPACE_H
+
+// Antioch
+#include "antioch/reaction_set.h"
+
+// C++
+#include <deque>
+#include <vector>
+
+namespace Antioch
+{
+  //! Work arrays of the kinetics evaluators
+  /*! The evaluators (KineticsEvaluator, BatchKineticsEvaluator) only read
+   *  the reaction set, all the mutable data of an evaluation lives here.
+   *  One evaluator can then be shared by several threads as long as each
+   *  thread uses its own workspace.
+   *
+   *  The derivative arrays (n_reactions x n_species values) are only
+   *  allocated the first time they are needed.
+   *
+   *  The work arrays are the scratch of the compiled evaluations (see
+   *  CompiledReactionSet), they keep their capacity between evaluations
+   *  so an evaluation allocates nothing once the workspace is warm.
+   */
+  template<typename StateType>
+  class KineticsWorkspace
+  {
+  public:
+
+    //! Constructor.  Requires the reaction set to be evaluated, as
+    //well as an \p example instantiation of the data type to be
+    //used as inputs.
+    template<typename CoeffType>
+    KineticsWorkspace( const ReactionSet<CoeffType>& reaction_set,
+                       const StateType& example );
+
+    ~KineticsWorkspace();
+
+    //! Rates of progress, one per reaction
+    std::vector<StateType>& net_reaction_rates();
+
+    //! Temperature derivatives of the rates of progress
+    std::vector<StateType>& dnet_rate_dT();
+
+    //! Molar densities derivatives of the rates of progress, n_reactions x n_species
+    std::vector<std::vector<StateType> >& dnet_rate_dX_s();
+
+    //! Work array \p i, resized to \p size
+    /*!
+     * The values are not reset, they are left to the caller. Getting
+     * a new work array leaves the references to the others valid.
+     */
+    std::vector<StateType>& work_array( unsigned int i, unsigned int size );
+
+  protected:
+
+    unsigned int _n_reactions;
+
+    unsigned int _n_species;
+
+    StateType _example;
+
+    std::vector<StateType> _net_reaction_rates;
+
+    std::vector<StateType> _dnet_rate_dT;
+
+    std::vector<std::vector<StateType> > _dnet_rate_dX_s;
+
+    std::deque<std::vector<StateType> > _work_arrays;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename StateType>
+  template<typename CoeffType>
+  inline
+  KineticsWorkspace<StateType>::KineticsWorkspace( const ReactionSet<CoeffType>& reaction_set,
+                                                   const StateType& example )
+    : _n_reactions( reaction_set.n_reactions() ),
+      _n_species( reaction_set.n_species() ),
+      _example( example ),
+      _net_reaction_rates( reaction_set.n_reactions(), example )
+  {
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  KineticsWorkspace<StateType>::~KineticsWorkspace()
+  {
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  std::vector<StateType>& KineticsWorkspace<StateType>::net_reaction_rates()
+  {
+    return _net_reaction_rates;
+  }
+
+  template<typename StateType>
+  inline
+  std::vector<StateType>& KineticsWorkspace<StateType>::dnet_rate_dT()
+  {
+    if( _dnet_rate_dT.size() != _n_reactions )
+      _dnet_rate_dT.resize( _n_reactions, _example );
+
+    return _dnet_rate_dT;
+  }
+
+  template<typename StateType>
+  inline
+  std::vector<std::vector<StateType> >& KineticsWorkspace<StateType>::dnet_rate_dX_s()
+  {
+    if( _dnet_rate_dX_s.size() != _n_reactions )
+      _dnet_rate_dX_s.resize( _n_reactions, std::vector<StateType>( _n_species, _example ) );
+
+    return _dnet_rate_dX_s;
+  }
+
+  template<typename StateType>
+  inline
+  std::vector<StateType>& KineticsWorkspace<StateType>::work_array( unsigned int i, unsigned int size )
+  {
+    if( i >= _work_arrays.size() )
+      _work_arrays.resize( i+1 );
+
+    _work_arrays[i].resize( size, _example );
+
+    return _work_arrays[i];
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_KINETICS_WORKSPACE_H
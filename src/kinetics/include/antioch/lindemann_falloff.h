@@ -77,6 +77,18 @@ namespace Antioch{
                            StateType &dF_dT,
                            VectorStateType &dF_dX) const;
 
+    //! F and its derivatives with respect to T and [M]
+    template <typename StateType>
+    void F_and_M_derivative(const StateType& T,
+                            const StateType &M,
+                            const StateType &k0,
+                            const StateType &dk0_dT,
+                            const StateType &kinf,
+                            const StateType &dkinf_dT,
+                            StateType &F,
+                            StateType &dF_dT,
+                            StateType &dF_dM) const;
+
   private:
     unsigned int n_spec;
 
@@ -130,6 +142,29 @@ namespace Antioch{
     return;
   }
 
+  template <typename CoeffType>
+  template <typename StateType>
+  inline
+  void LindemannFalloff<CoeffType>::F_and_M_derivative
+    (const StateType& T,
+     const StateType& /* M */,
+     const StateType& /* k0 */,
+     const StateType& /* dk0_dT */,
+     const StateType& /* kinf */,
+     const StateType& /* dkinf_dT */,
+     StateType& F,
+     StateType& dF_dT,
+     StateType& dF_dM) const
+  {
+    //all derived are 0
+    dF_dT = Antioch::zero_clone(T);
+    dF_dM = Antioch::zero_clone(T);
+    // F = 1
+    F = Antioch::constant_clone(T,1);
+
+    return;
+  }
+
   template<typename CoeffType>
   inline
   LindemannFalloff<CoeffType>::LindemannFalloff(const unsigned int nspec):n_spec(nspec)
@@ -0,0 +1,540 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_MIXED_PRECISION_KINETICS_EVALUATOR_H
+#define ANTIOCH_MIXED_PRECISION_KINETICS_EVALUATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming.h"
+#include "antioch/physical_constants.h"
+#include "antioch/temp_cache.h"
+#include "antioch/reaction_set.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_workspace.h"
+
+// C++
+#include <limits>
+#include <vector>
+
+namespace Antioch
+{
+  //! Reactions of \p reaction_set whose rate constants leave the range of \p ReducedType
+  /*! The rate constants are written
+   *  \f$k(T) = C_f\, T^\eta \exp\left(-\frac{E_a}{T}\right) \exp(D\,T)\f$
+   *  (see CompiledReactionSet::rate_parameters()) and the kinetics models
+   *  multiply these factors in various orders. A reaction is flagged if, at
+   *  some temperature of [\p T_min, \p T_max], a product of some of these
+   *  factors comes within \p headroom of the smallest normalized or of the
+   *  largest value of \p ReducedType. The headroom leaves room for the
+   *  concentrations the rate constants are then multiplied by.
+   *
+   *  The equilibrium constants are not checked, see the overload taking
+   *  a thermodynamics evaluator. Photochemical reactions have no
+   *  analytical rate constant and are always flagged.
+   *
+   *  \p unsafe_reactions is filled with the flagged reactions, in
+   *  increasing order.
+   */
+  template<typename ReducedType, typename CoeffType>
+  void reduced_precision_unsafe_reactions( const ReactionSet<CoeffType>& reaction_set,
+                                           const CoeffType& T_min,
+                                           const CoeffType& T_max,
+                                           std::vector<unsigned int>& unsafe_reactions,
+                                           const CoeffType& headroom = 1e6 );
+
+  //! Reactions of \p reaction_set whose rate or equilibrium constants leave the range of \p ReducedType
+  /*! Same as above, the backward rate constant \f$k_f/K_{eq}\f$ of the
+   *  reversible reactions is also checked. \p thermo provides
+   *  \f$\frac{h}{RT} - \frac{s}{R}\f$ through
+   *  h_RT_minus_s_R(const TempCache<CoeffType>&, std::vector<CoeffType>&).
+   */
+  template<typename ReducedType, typename CoeffType, typename ThermoEvaluator>
+  void reduced_precision_unsafe_reactions( const ReactionSet<CoeffType>& reaction_set,
+                                           const ThermoEvaluator& thermo,
+                                           const CoeffType& T_min,
+                                           const CoeffType& T_max,
+                                           std::vector<unsigned int>& unsafe_reactions,
+                                           const CoeffType& headroom = 1e6 );
+
+  //! Class to handle computing source terms in a reduced precision for a given ReactionSet.
+  /*! The rate constants and the rates of progress are evaluated in \p StateType
+   *  (typically float, with a ReactionSet<float>), while the species sources and
+   *  their derivatives are accumulated in the value type of the vectors given
+   *  to the compute methods (typically double): the inputs are rounded to
+   *  \p StateType, the output keeps the cancellations between the reactions
+   *  from losing more accuracy.
+   *
+   *  The results are only accurate to the precision of \p StateType, and only
+   *  if no rate constant leaves its range, see
+   *  reduced_precision_unsafe_reactions() on the reaction set in the
+   *  full precision. Photochemical reactions are not supported.
+   *
+   *  As the KineticsEvaluator methods without a workspace, this class
+   *  preallocates work arrays and so *must* be created within a spawned
+   *  thread, if running in a threaded environment.
+   */
+  template<typename CoeffType=float, typename StateType=CoeffType>
+  class MixedPrecisionKineticsEvaluator
+  {
+  public:
+
+    //! Constructor.  Requires a reaction set to be evaluated later,
+    //as well as an \p example instantiation of the data type to be
+    //used for the rates of progress.
+    MixedPrecisionKineticsEvaluator( const ReactionSet<CoeffType>& reaction_set,
+                                     const StateType& example );
+
+    ~MixedPrecisionKineticsEvaluator();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    unsigned int n_species() const;
+
+    unsigned int n_reactions() const;
+
+    //! Compute species molar production/destruction rates per unit volume
+    /*! \f$ \left(mole/sec/m^3\right)\f$ */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mole_sources );
+
+    //! Compute species molar production/destruction rate derivatives
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mole_sources,
+                                          VectorStateType& dmole_dT,
+                                          std::vector<VectorStateType>& dmole_dX_s );
+
+    //! Compute species production/destruction rates per unit volume
+    /*! \f$ \left(kg/sec/m^3\right)\f$ */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mass_sources );
+
+    //! Compute species production/destruction rate derivatives, in mass units
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mass_sources,
+                                          VectorStateType& dmass_dT,
+                                          std::vector<VectorStateType>& dmass_drho_s );
+
+  protected:
+
+    //! Rounds \p values to \p StateType
+    template <typename VectorStateType>
+    static void reduce( const VectorStateType& values, std::vector<StateType>& reduced );
+
+    //! Temperature of \p conditions, rounded to \p StateType
+    template <typename VectorStateType, typename KC>
+    static StateType reduced_temperature( const KC& conditions );
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    KineticsWorkspace<StateType> _workspace;
+
+    std::vector<StateType> _molar_densities;
+
+    std::vector<StateType> _h_RT_minus_s_R;
+
+    std::vector<StateType> _dh_RT_minus_s_R_dT;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  namespace MixedPrecision
+  {
+    //! Whether all the partial sums of \p log_factors are within [\p lower, \p upper]
+    template<typename CoeffType>
+    inline
+    bool partial_sums_in_range( const CoeffType* log_factors, unsigned int n_factors,
+                                const CoeffType& lower, const CoeffType& upper )
+    {
+      for(unsigned int subset = 1; subset < (1u << n_factors); subset++)
+        {
+          CoeffType sum = 0;
+          for(unsigned int f = 0; f < n_factors; f++)
+            if(subset & (1u << f))
+              sum += log_factors[f];
+
+          // also false for NaN
+          if( !(sum >= lower && sum <= upper) )
+            return false;
+        }
+
+      return true;
+    }
+
+    //! Flags the reactions out of range
+    /*! \p log_keq holds, for each temperature and reaction \f$r\f$, the
+     *  logarithms of the two factors of the equilibrium constant
+     *  \f$(P_0/RT)^{\gamma_r}\f$ and \f$\exp(-\Delta_r G^0/RT)\f$ at 2r and 2r+1.
+     *  It is NULL if the equilibrium constants are not checked. */
+    template<typename ReducedType, typename CoeffType>
+    inline
+    void unsafe_reactions( const ReactionSet<CoeffType>& reaction_set,
+                           const std::vector<CoeffType>& temperatures,
+                           const std::vector<std::vector<CoeffType> >* log_keq,
+                           const CoeffType& headroom,
+                           std::vector<unsigned int>& unsafe_reactions )
+    {
+      using std::log;
+
+      antioch_assert_greater_equal( headroom, 1 );
+
+      const CoeffType lower = log(CoeffType(std::numeric_limits<ReducedType>::min())) + log(headroom);
+      const CoeffType upper = log(CoeffType(std::numeric_limits<ReducedType>::max())) - log(headroom);
+
+      unsafe_reactions.clear();
+
+      for(unsigned int rxn = 0; rxn < reaction_set.n_reactions(); rxn++)
+        {
+          const Reaction<CoeffType>& reaction = reaction_set.reaction(rxn);
+
+          bool safe = true;
+          for(unsigned int ir = 0; safe && ir < reaction.n_rate_constants(); ir++)
+            {
+              CoeffType Cf, eta, Ea, D;
+              if( !CompiledReactionSet<CoeffType>::rate_parameters( reaction.forward_rate(ir), Cf, eta, Ea, D ) )
+                {
+                  safe = false;
+                  break;
+                }
+
+              // a zero rate constant is exactly zero in any precision
+              if(Cf == 0)
+                continue;
+
+              for(unsigned int i = 0; safe && i < temperatures.size(); i++)
+                {
+                  const CoeffType& T = temperatures[i];
+
+                  CoeffType log_factors[6] = { log(std::abs(Cf)), eta * log(T), -Ea/T, D * T, 0, 0 };
+                  unsigned int n_factors = 4;
+                  if(log_keq && reaction.reversible())
+                    {
+                      // the equilibrium constant, then the backward rate constant
+                      const CoeffType* log_keq_factors = &(*log_keq)[i][2*rxn];
+                      safe = partial_sums_in_range( log_keq_factors, 2, lower, upper );
+
+                      log_factors[n_factors++] = -log_keq_factors[0];
+                      log_factors[n_factors++] = -log_keq_factors[1];
+                    }
+
+                  safe = safe && partial_sums_in_range( log_factors, n_factors, lower, upper );
+                }
+            }
+
+          if(!safe)
+            unsafe_reactions.push_back(rxn);
+        }
+    }
+
+    //! Geometric sampling of [\p T_min, \p T_max]
+    template<typename CoeffType>
+    inline
+    void sample_temperatures( const CoeffType& T_min, const CoeffType& T_max,
+                              std::vector<CoeffType>& temperatures )
+    {
+      using std::pow;
+
+      antioch_assert_greater( T_min, 0 );
+      antioch_assert_greater_equal( T_max, T_min );
+
+      const unsigned int n_intervals = 32;
+      temperatures.resize(n_intervals + 1);
+      for(unsigned int i = 0; i <= n_intervals; i++)
+        temperatures[i] = T_min * pow( T_max/T_min, CoeffType(i)/CoeffType(n_intervals) );
+      temperatures.back() = T_max;
+    }
+  } // end namespace MixedPrecision
+
+  template<typename ReducedType, typename CoeffType>
+  inline
+  void reduced_precision_unsafe_reactions( const ReactionSet<CoeffType>& reaction_set,
+                                           const CoeffType& T_min,
+                                           const CoeffType& T_max,
+                                           std::vector<unsigned int>& unsafe_reactions,
+                                           const CoeffType& headroom )
+  {
+    std::vector<CoeffType> temperatures;
+    MixedPrecision::sample_temperatures( T_min, T_max, temperatures );
+
+    MixedPrecision::unsafe_reactions<ReducedType,CoeffType>( reaction_set, temperatures, NULL, headroom, unsafe_reactions );
+  }
+
+  template<typename ReducedType, typename CoeffType, typename ThermoEvaluator>
+  inline
+  void reduced_precision_unsafe_reactions( const ReactionSet<CoeffType>& reaction_set,
+                                           const ThermoEvaluator& thermo,
+                                           const CoeffType& T_min,
+                                           const CoeffType& T_max,
+                                           std::vector<unsigned int>& unsafe_reactions,
+                                           const CoeffType& headroom )
+  {
+    using std::log;
+
+    std::vector<CoeffType> temperatures;
+    MixedPrecision::sample_temperatures( T_min, T_max, temperatures );
+
+    // factors of the equilibrium constant as in Reaction::equilibrium_constant(),
+    // without the exponential that could overflow
+    const CoeffType P0_R = 1.0e5/Constants::R_universal<CoeffType>();
+    const std::vector<CoeffType>& gamma = reaction_set.stoichiometric_matrix().gamma();
+
+    std::vector<CoeffType> h_RT_minus_s_R( reaction_set.n_species() );
+    std::vector<CoeffType> delta_G_RT( reaction_set.n_reactions() );
+    std::vector<std::vector<CoeffType> > log_keq( temperatures.size(),
+                                                  std::vector<CoeffType>( 2 * reaction_set.n_reactions() ) );
+
+    for(unsigned int i = 0; i < temperatures.size(); i++)
+      {
+        const TempCache<CoeffType> cache( temperatures[i] );
+        thermo.h_RT_minus_s_R( cache, h_RT_minus_s_R );
+
+        reaction_set.stoichiometric_matrix().multiply_transpose( h_RT_minus_s_R, delta_G_RT );
+
+        const CoeffType log_P0_RT = log( P0_R/temperatures[i] );
+        for(unsigned int rxn = 0; rxn < reaction_set.n_reactions(); rxn++)
+          {
+            log_keq[i][2*rxn]   = gamma[rxn] * log_P0_RT;
+            log_keq[i][2*rxn+1] = -delta_G_RT[rxn];
+          }
+      }
+
+    MixedPrecision::unsafe_reactions<ReducedType>( reaction_set, temperatures, &log_keq, headroom, unsafe_reactions );
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  MixedPrecisionKineticsEvaluator<CoeffType,StateType>::MixedPrecisionKineticsEvaluator
+  ( const ReactionSet<CoeffType>& reaction_set,
+    const StateType& example )
+    : _reaction_set( reaction_set ),
+      _chem_mixture( reaction_set.chemical_mixture() ),
+      _workspace( reaction_set, example ),
+      _molar_densities( reaction_set.n_species(), example ),
+      _h_RT_minus_s_R( reaction_set.n_species(), example ),
+      _dh_RT_minus_s_R_dT( reaction_set.n_species(), example )
+  {
+    // photochemical reactions are unsupported: the particle fluxes are not
+    // carried over to the reduced precision conditions
+    for(unsigned int rxn = 0; rxn < reaction_set.n_reactions(); rxn++)
+      {
+        const Reaction<CoeffType>& reaction = reaction_set.reaction(rxn);
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          if( reaction.forward_rate(ir).type() == KineticsModel::PHOTOCHEM )
+            antioch_error_msg( "MixedPrecisionKineticsEvaluator does not support the photochemical reaction "
+                               << reaction.id() );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  MixedPrecisionKineticsEvaluator<CoeffType,StateType>::~MixedPrecisionKineticsEvaluator()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const ReactionSet<CoeffType>& MixedPrecisionKineticsEvaluator<CoeffType,StateType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  unsigned int MixedPrecisionKineticsEvaluator<CoeffType,StateType>::n_species() const
+  {
+    return _chem_mixture.n_species();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  unsigned int MixedPrecisionKineticsEvaluator<CoeffType,StateType>::n_reactions() const
+  {
+    return _reaction_set.n_reactions();
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType>
+  inline
+  void MixedPrecisionKineticsEvaluator<CoeffType,StateType>::reduce( const VectorStateType& values,
+                                                                     std::vector<StateType>& reduced )
+  {
+    antioch_assert_equal_to( values.size(), reduced.size() );
+
+    for(unsigned int s = 0; s < reduced.size(); s++)
+      reduced[s] = static_cast<StateType>(values[s]);
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  StateType MixedPrecisionKineticsEvaluator<CoeffType,StateType>::reduced_temperature( const KC& conditions )
+  {
+    typedef typename value_type<VectorStateType>::type AccumType;
+
+    typename constructor_or_reference<const KineticsConditions<AccumType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                kinetics_conditions(conditions);
+
+    return static_cast<StateType>(kinetics_conditions.T());
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void MixedPrecisionKineticsEvaluator<CoeffType,StateType>::compute_mole_sources( const KC& conditions,
+                                                                                  const VectorStateType& molar_densities,
+                                                                                  const VectorStateType& h_RT_minus_s_R,
+                                                                                  VectorStateType& mole_sources )
+  {
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+
+    std::vector<StateType>& net_reaction_rates = _workspace.net_reaction_rates();
+
+    reduce( molar_densities, _molar_densities );
+    reduce( h_RT_minus_s_R, _h_RT_minus_s_R );
+
+    const StateType T = reduced_temperature<VectorStateType>(conditions);
+    const KineticsConditions<StateType> reduced_conditions( T );
+
+    Antioch::set_zero(net_reaction_rates);
+
+    this->_reaction_set.compute_reaction_rates( reduced_conditions, _molar_densities,
+                                                _h_RT_minus_s_R, net_reaction_rates );
+
+    // the sums over the reactions are done in the precision of mole_sources
+    this->_reaction_set.stoichiometric_matrix().multiply( net_reaction_rates, mole_sources );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void MixedPrecisionKineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_derivs( const KC& conditions,
+                                                                                             const VectorStateType& molar_densities,
+                                                                                             const VectorStateType& h_RT_minus_s_R,
+                                                                                             const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                             VectorStateType& mole_sources,
+                                                                                             VectorStateType& dmole_dT,
+                                                                                             std::vector<VectorStateType>& dmole_dX_s )
+  {
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dT.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dX_s.size(), this->n_species() );
+
+    std::vector<StateType>& net_reaction_rates = _workspace.net_reaction_rates();
+    std::vector<StateType>& dnet_rate_dT = _workspace.dnet_rate_dT();
+    std::vector<std::vector<StateType> >& dnet_rate_dX_s = _workspace.dnet_rate_dX_s();
+
+    reduce( molar_densities, _molar_densities );
+    reduce( h_RT_minus_s_R, _h_RT_minus_s_R );
+    reduce( dh_RT_minus_s_R_dT, _dh_RT_minus_s_R_dT );
+
+    const StateType T = reduced_temperature<VectorStateType>(conditions);
+    const KineticsConditions<StateType> reduced_conditions( T );
+
+    Antioch::set_zero(net_reaction_rates);
+    Antioch::set_zero(dnet_rate_dT);
+    for (unsigned int rxn=0; rxn < this->n_reactions(); rxn++)
+      Antioch::set_zero(dnet_rate_dX_s[rxn]);
+
+    this->_reaction_set.compute_reaction_rates_and_derivs( reduced_conditions, _molar_densities,
+                                                           _h_RT_minus_s_R, _dh_RT_minus_s_R_dT,
+                                                           net_reaction_rates,
+                                                           dnet_rate_dT,
+                                                           dnet_rate_dX_s );
+
+    // the sums over the reactions are done in the precision of the outputs
+    const StoichiometricMatrix<CoeffType>& nu = this->_reaction_set.stoichiometric_matrix();
+    nu.multiply( net_reaction_rates, mole_sources );
+    nu.multiply( dnet_rate_dT, dmole_dT );
+    nu.multiply_rows( dnet_rate_dX_s, dmole_dX_s );
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void MixedPrecisionKineticsEvaluator<CoeffType,StateType>::compute_mass_sources( const KC& conditions,
+                                                                                  const VectorStateType& molar_densities,
+                                                                                  const VectorStateType& h_RT_minus_s_R,
+                                                                                  VectorStateType& mass_sources )
+  {
+    this->compute_mole_sources( conditions, molar_densities, h_RT_minus_s_R, mass_sources );
+
+    for (unsigned int s=0; s < this->n_species(); s++)
+      mass_sources[s] *= _chem_mixture.M(s);
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void MixedPrecisionKineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( const KC& conditions,
+                                                                                             const VectorStateType& molar_densities,
+                                                                                             const VectorStateType& h_RT_minus_s_R,
+                                                                                             const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                             VectorStateType& mass_sources,
+                                                                                             VectorStateType& dmass_dT,
+                                                                                             std::vector<VectorStateType>& dmass_drho_s )
+  {
+    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           mass_sources, dmass_dT, dmass_drho_s );
+
+    // Convert from mole units to mass units
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        mass_sources[s] *= _chem_mixture.M(s);
+        dmass_dT[s] *= _chem_mixture.M(s);
+
+        for (unsigned int t=0; t < this->n_species(); t++)
+          dmass_drho_s[s][t] *= _chem_mixture.M(s)/_chem_mixture.M(t);
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_MIXED_PRECISION_KINETICS_EVALUATOR_H
@@ -0,0 +1,359 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_PARALLEL_BATCH_KINETICS_EVALUATOR_H
+#define ANTIOCH_PARALLEL_BATCH_KINETICS_EVALUATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/batch_kinetics_evaluator.h"
+#include "antioch/kinetics_workspace.h"
+
+// C++
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Antioch
+{
+  //! Spreads the cells of a batch over several threads
+  /*! The cells of a batch (see BatchKineticsEvaluator for the layout) are
+   *  first split evenly between the threads. Each thread then evaluates its
+   *  cells chunk by chunk, and once it runs out of cells steals the upper
+   *  half of the cells left to another thread, so threads hitting cheaper
+   *  cells do not wait for the others.
+   *
+   *  The BatchKineticsEvaluator is shared, this class keeps one
+   *  KineticsWorkspace per thread from one batch to the next, and each
+   *  thread writes the sources of its cells in place. Threads are spawned
+   *  for each batch. As the workspaces are owned here, an instance must
+   *  not be used by several callers at once.
+   */
+  template<typename CoeffType=double>
+  class ParallelBatchKineticsEvaluator
+  {
+  public:
+
+    //! Constructor.  \p n_threads equal to zero uses one thread per core,
+    //cells are evaluated by chunks of \p chunk_size cells.
+    ParallelBatchKineticsEvaluator( const BatchKineticsEvaluator<CoeffType>& evaluator,
+                                    unsigned int n_threads = 0,
+                                    unsigned int chunk_size = 64 );
+
+    ~ParallelBatchKineticsEvaluator();
+
+    unsigned int n_threads() const;
+
+    unsigned int chunk_size() const;
+
+    //! Compute species molar production/destruction rates per unit volume, on \p n_cells cells
+    /*! \f$ \left(mole/sec/m^3\right)\f$ */
+    void compute_mole_sources( unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mole_sources );
+
+    //! Compute species production/destruction rates per unit volume, on \p n_cells cells
+    /*! \f$ \left(kg/sec/m^3\right)\f$ */
+    void compute_mass_sources( unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mass_sources );
+
+  protected:
+
+    //! Cells left to a thread
+    struct CellRange
+    {
+      std::mutex mutex;
+      unsigned int begin;
+      unsigned int end;
+    };
+
+    void compute_sources( bool mass,
+                          unsigned int n_cells,
+                          const std::vector<CoeffType>& T,
+                          const std::vector<CoeffType>& molar_densities,
+                          const std::vector<CoeffType>& h_RT_minus_s_R,
+                          std::vector<CoeffType>& sources );
+
+    //! Evaluates the cells of thread \p t, then steals cells from the others
+    void run( unsigned int t,
+              bool mass,
+              std::vector<CellRange>& ranges,
+              unsigned int n_cells,
+              const std::vector<CoeffType>& T,
+              const std::vector<CoeffType>& molar_densities,
+              const std::vector<CoeffType>& h_RT_minus_s_R,
+              std::vector<CoeffType>& sources );
+
+    //! Next chunk of thread \p t, false if it has no cell left
+    bool next_chunk( CellRange& range, unsigned int& begin, unsigned int& end ) const;
+
+    //! Moves the upper half of the cells of another thread to thread \p t
+    bool steal( unsigned int t, std::vector<CellRange>& ranges ) const;
+
+    const BatchKineticsEvaluator<CoeffType>& _evaluator;
+
+    unsigned int _n_threads;
+
+    unsigned int _chunk_size;
+
+    //! one per thread, kept between batches
+    std::vector<KineticsWorkspace<CoeffType> > _workspaces;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  ParallelBatchKineticsEvaluator<CoeffType>::ParallelBatchKineticsEvaluator( const BatchKineticsEvaluator<CoeffType>& evaluator,
+                                                                             unsigned int n_threads,
+                                                                             unsigned int chunk_size )
+    : _evaluator(evaluator),
+      _n_threads(n_threads),
+      _chunk_size(chunk_size)
+  {
+    if(_n_threads == 0)
+      _n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    antioch_assert_greater(_chunk_size, 0);
+
+    _workspaces.resize(_n_threads, KineticsWorkspace<CoeffType>(_evaluator.reaction_set(), 0));
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  ParallelBatchKineticsEvaluator<CoeffType>::~ParallelBatchKineticsEvaluator()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ParallelBatchKineticsEvaluator<CoeffType>::n_threads() const
+  {
+    return _n_threads;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ParallelBatchKineticsEvaluator<CoeffType>::chunk_size() const
+  {
+    return _chunk_size;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ParallelBatchKineticsEvaluator<CoeffType>::compute_mole_sources( unsigned int n_cells,
+                                                                        const std::vector<CoeffType>& T,
+                                                                        const std::vector<CoeffType>& molar_densities,
+                                                                        const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                        std::vector<CoeffType>& mole_sources )
+  {
+    this->compute_sources( false, n_cells, T, molar_densities, h_RT_minus_s_R, mole_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void ParallelBatchKineticsEvaluator<CoeffType>::compute_mass_sources( unsigned int n_cells,
+                                                                        const std::vector<CoeffType>& T,
+                                                                        const std::vector<CoeffType>& molar_densities,
+                                                                        const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                        std::vector<CoeffType>& mass_sources )
+  {
+    this->compute_sources( true, n_cells, T, molar_densities, h_RT_minus_s_R, mass_sources );
+  }
+
+  template<typename CoeffType>
+  inline
+  void ParallelBatchKineticsEvaluator<CoeffType>::compute_sources( bool mass,
+                                                                   unsigned int n_cells,
+                                                                   const std::vector<CoeffType>& T,
+                                                                   const std::vector<CoeffType>& molar_densities,
+                                                                   const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                   std::vector<CoeffType>& sources )
+  {
+    const unsigned int n_species = _evaluator.n_species();
+
+    antioch_assert_equal_to( T.size(), n_cells );
+    antioch_assert_equal_to( molar_densities.size(), n_species * n_cells );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), n_species * n_cells );
+    antioch_assert_equal_to( sources.size(), n_species * n_cells );
+    (void)n_species;
+
+    // no more threads than chunks
+    const unsigned int n_threads = std::max(1u, std::min(_n_threads, (n_cells + _chunk_size - 1)/_chunk_size));
+
+    // even split to begin with
+    std::vector<CellRange> ranges(n_threads);
+    for(unsigned int t = 0; t < n_threads; t++)
+      {
+        ranges[t].begin = static_cast<unsigned int>((static_cast<unsigned long>(n_cells) * t)/n_threads);
+        ranges[t].end   = static_cast<unsigned int>((static_cast<unsigned long>(n_cells) * (t+1))/n_threads);
+      }
+
+    // errors are rethrown in the calling thread
+    std::vector<std::exception_ptr> errors(n_threads);
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1);
+
+    try
+      {
+        for(unsigned int t = 1; t < n_threads; t++)
+          {
+            threads.push_back( std::thread( [&,t]()
+                                            {
+                                              try
+                                                {
+                                                  this->run(t, mass, ranges, n_cells, T, molar_densities, h_RT_minus_s_R, sources);
+                                                }
+                                              catch(...)
+                                                {
+                                                  errors[t] = std::current_exception();
+                                                }
+                                            } ) );
+          }
+      }
+    catch(...)
+      {
+        // a joinable thread must not be destroyed, the threads
+        // already started finish their cells before we rethrow
+        for(unsigned int t = 0; t < threads.size(); t++)
+          threads[t].join();
+        throw;
+      }
+
+    // the calling thread takes its share
+    try
+      {
+        this->run(0, mass, ranges, n_cells, T, molar_densities, h_RT_minus_s_R, sources);
+      }
+    catch(...)
+      {
+        errors[0] = std::current_exception();
+      }
+
+    for(unsigned int t = 0; t < threads.size(); t++)
+      threads[t].join();
+
+    for(unsigned int t = 0; t < n_threads; t++)
+      {
+        if(errors[t])
+          std::rethrow_exception(errors[t]);
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ParallelBatchKineticsEvaluator<CoeffType>::next_chunk( CellRange& range, unsigned int& begin, unsigned int& end ) const
+  {
+    std::lock_guard<std::mutex> lock(range.mutex);
+
+    if(range.begin == range.end)
+      return false;
+
+    begin = range.begin;
+    end   = std::min(range.end, range.begin + _chunk_size);
+    range.begin = end;
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ParallelBatchKineticsEvaluator<CoeffType>::steal( unsigned int t, std::vector<CellRange>& ranges ) const
+  {
+    const unsigned int n_threads = ranges.size();
+
+    for(unsigned int i = 1; i < n_threads; i++)
+      {
+        CellRange& victim = ranges[(t + i) % n_threads];
+
+        unsigned int begin, end;
+        {
+          std::lock_guard<std::mutex> lock(victim.mutex);
+          if(victim.begin == victim.end)
+            continue;
+
+          // upper half, at least one cell
+          end   = victim.end;
+          begin = victim.begin + (victim.end - victim.begin)/2;
+          victim.end = begin;
+        }
+
+        std::lock_guard<std::mutex> lock(ranges[t].mutex);
+        ranges[t].begin = begin;
+        ranges[t].end   = end;
+
+        return true;
+      }
+
+    return false;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ParallelBatchKineticsEvaluator<CoeffType>::run( unsigned int t,
+                                                       bool mass,
+                                                       std::vector<CellRange>& ranges,
+                                                       unsigned int n_cells,
+                                                       const std::vector<CoeffType>& T,
+                                                       const std::vector<CoeffType>& molar_densities,
+                                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                       std::vector<CoeffType>& sources )
+  {
+    KineticsWorkspace<CoeffType>& workspace = _workspaces[t];
+
+    unsigned int begin, end;
+    while(true)
+      {
+        if( !this->next_chunk(ranges[t], begin, end) )
+          {
+            // nothing left anywhere
+            if( !this->steal(t, ranges) )
+              break;
+            continue;
+          }
+
+        // the chunk is read and written in place, the ranges are disjoint
+        if(mass)
+          _evaluator.compute_mass_sources(workspace, n_cells, begin, end, T, molar_densities, h_RT_minus_s_R, sources);
+        else
+          _evaluator.compute_mole_sources(workspace, n_cells, begin, end, T, molar_densities, h_RT_minus_s_R, sources);
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_PARALLEL_BATCH_KINETICS_EVALUATOR_H
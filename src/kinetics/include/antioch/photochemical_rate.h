@@ -35,18 +35,26 @@
 #include "antioch/particle_flux.h"
 
 //C++
+#include <memory>
 #include <vector>
 #include <string>
 #include <sstream>
 
 namespace Antioch{
   /*!Photochemical rate
+   *
+   * The cross-section rebinned on the abscissa of a ParticleFlux<VectorCoeffType>
+   * is kept, and computed again only when the rate is evaluated with a
+   * flux of another abscissa (see ParticleFlux::abscissa_version()) or
+   * when the cross-section or its grid are modified. Fluxes of other
+   * types are rebinned at each evaluation.
+   *
+   * Every modification of the cross-section or of its grid increments
+   * parameter_version(), so that values cached from them elsewhere
+   * (e.g. by PhotolysisRates) can be detected as stale.
    *
    * \todo Need to find a place to store k once calculated,
    * and recalculate only if the photon flux has changed.
-   * Might want also to re-put _cross_section_on_flux_grid,
-   * as usually, changes will appear in the photon flux, not
-   * the lambda grid.
    *
    */
   template<typename CoeffType, typename VectorCoeffType = std::vector<CoeffType> >
@@ -58,6 +66,30 @@ namespace Antioch{
        VectorCoeffType _lambda_grid;
        SigmaBinConverter<VectorCoeffType> _converter;
 
+       //! Cross-section on the abscissa of a flux
+       struct RebinnedCrossSection
+       {
+         RebinnedCrossSection(unsigned long version, unsigned int size);
+
+         unsigned long abscissa_version;
+         VectorCoeffType cross_section;
+       };
+
+       //! Last rebinned cross-section, replaced as a whole so concurrent evaluations can share it
+       mutable std::shared_ptr<const RebinnedCrossSection> _rebinned;
+
+       //! Counter of the modifications of the cross-section and its grid
+       unsigned int _parameter_version;
+
+       //! Increments the parameter version, the next evaluation rebins the cross-section
+       void parameters_changed();
+
+       //! \f$\sum_i \sigma_i \phi_i (\lambda_{i+1} - \lambda_i)\f$, right stairs
+       template <typename VectorStateType, typename VectorSigmaType>
+       typename value_type<VectorStateType>::type
+                integrate(const VectorSigmaType& cross_section_on_flux_grid,
+                          const ParticleFlux<VectorStateType>& pf) const;
+
      public:
        PhotochemicalRate(const VectorCoeffType &cs, const VectorCoeffType &lambda);
        PhotochemicalRate();
@@ -67,6 +99,9 @@ namespace Antioch{
        VectorCoeffType cross_section() const;
        VectorCoeffType lambda_grid()   const;
 
+       //! Counter of the modifications of the cross-section and its grid
+       unsigned int parameter_version() const;
+
 
        //!
        void set_cross_section(const VectorCoeffType &cs);
@@ -108,6 +143,9 @@ namespace Antioch{
        typename value_type<VectorStateType>::type 
                 rate(const ParticleFlux<VectorStateType>& pf) const;
 
+       //! \return the rate evaluated at the given photon spectrum, with the cached rebinned cross-section.
+       CoeffType rate(const ParticleFlux<VectorCoeffType>& pf) const;
+
        //! \return the derivative with respect to temperature.
        template <typename VectorStateType>
        ANTIOCH_AUTO(typename value_type<VectorStateType>::type)
@@ -129,7 +167,8 @@ namespace Antioch{
                                                                   const VectorCoeffType &lambda):
     KineticsType<CoeffType,VectorCoeffType>(KineticsModel::PHOTOCHEM),
     _cross_section(cs),
-    _lambda_grid(lambda)
+    _lambda_grid(lambda),
+    _parameter_version(0)
   {
     return;
   }
@@ -137,7 +176,8 @@ namespace Antioch{
   template<typename CoeffType, typename VectorCoeffType>
   inline
   PhotochemicalRate<CoeffType,VectorCoeffType>::PhotochemicalRate():
-    KineticsType<CoeffType,VectorCoeffType>(KineticsModel::PHOTOCHEM)
+    KineticsType<CoeffType,VectorCoeffType>(KineticsModel::PHOTOCHEM),
+    _parameter_version(0)
   {
     return;
   }
@@ -149,11 +189,30 @@ namespace Antioch{
     return;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  PhotochemicalRate<CoeffType,VectorCoeffType>::RebinnedCrossSection::RebinnedCrossSection(unsigned long version,
+                                                                                          unsigned int size):
+    abscissa_version(version),
+    cross_section(size)
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void PhotochemicalRate<CoeffType,VectorCoeffType>::parameters_changed()
+  {
+    _parameter_version++;
+    std::atomic_store(&_rebinned, std::shared_ptr<const RebinnedCrossSection>());
+  }
+
   template<typename CoeffType, typename VectorCoeffType>
   inline
   void PhotochemicalRate<CoeffType,VectorCoeffType>::set_cross_section(const VectorCoeffType &cs)
   {
     _cross_section = cs;
+    this->parameters_changed();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -161,6 +220,7 @@ namespace Antioch{
   void PhotochemicalRate<CoeffType,VectorCoeffType>::set_lambda_grid(const VectorCoeffType &l)
   {
      _lambda_grid = l;
+     this->parameters_changed();
   }
   template<typename CoeffType, typename VectorCoeffType>
   inline
@@ -169,6 +229,7 @@ namespace Antioch{
      antioch_assert_less(il,_cross_section.size());
 
     _cross_section[il] = cs;
+    this->parameters_changed();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -178,6 +239,7 @@ namespace Antioch{
      antioch_assert_less(il,_lambda_grid.size());
 
      _lambda_grid[il] = l;
+     this->parameters_changed();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -259,7 +321,6 @@ namespace Antioch{
   typename value_type<VectorStateType>::type 
         PhotochemicalRate<CoeffType,VectorCoeffType>::rate(const ParticleFlux<VectorStateType> & pf) const
   {
-     const VectorStateType &hv_flux =  pf.flux();
      const VectorStateType &hv_lambda = pf.abscissa();
 
 //cross-section and lambda exists
@@ -272,7 +333,44 @@ namespace Antioch{
 //put them on the right grid
       _converter.y_on_custom_grid(_lambda_grid,_cross_section,hv_lambda,cross_section_on_flux_grid);
 
-//calculates
+      return this->integrate(cross_section_on_flux_grid,pf);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  CoeffType PhotochemicalRate<CoeffType,VectorCoeffType>::rate(const ParticleFlux<VectorCoeffType> & pf) const
+  {
+     const VectorCoeffType &hv_lambda = pf.abscissa();
+
+//cross-section and lambda exists
+     antioch_assert_greater(_cross_section.size(),0);
+     antioch_assert_greater(_lambda_grid.size(),0);
+
+// keeps the cross-section alive even if another evaluation replaces it
+     std::shared_ptr<const RebinnedCrossSection> rebinned = std::atomic_load(&_rebinned);
+
+     if(!rebinned || rebinned->abscissa_version != pf.abscissa_version())
+     {
+        std::shared_ptr<RebinnedCrossSection> new_rebinned(new RebinnedCrossSection(pf.abscissa_version(),hv_lambda.size()));
+        _converter.y_on_custom_grid(_lambda_grid,_cross_section,hv_lambda,new_rebinned->cross_section);
+
+        rebinned = new_rebinned;
+        std::atomic_store(&_rebinned, rebinned);
+     }
+
+     return this->integrate(rebinned->cross_section,pf);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename VectorStateType, typename VectorSigmaType>
+  inline
+  typename value_type<VectorStateType>::type
+        PhotochemicalRate<CoeffType,VectorCoeffType>::integrate(const VectorSigmaType & cross_section_on_flux_grid,
+                                                                const ParticleFlux<VectorStateType> & pf) const
+  {
+     const VectorStateType &hv_flux =  pf.flux();
+     const VectorStateType &hv_lambda = pf.abscissa();
+
       typename value_type<VectorStateType>::type k;
       Antioch::set_zero(k);
       for(unsigned int ibin = 0; ibin < hv_lambda.size() - 1; ibin++)
@@ -317,6 +415,13 @@ namespace Antioch{
      return _lambda_grid;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int PhotochemicalRate<CoeffType,VectorCoeffType>::parameter_version() const
+  {
+     return _parameter_version;
+  }
+
 } //end namespace Antioch
 
 #endif
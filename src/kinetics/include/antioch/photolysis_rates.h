@@ -0,0 +1,477 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_PHOTOLYSIS_RATES_H
+#define ANTIOCH_PHOTOLYSIS_RATES_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/particle_flux.h"
+#include "antioch/photochemical_rate.h"
+#include "antioch/sigma_bin_converter.h"
+#include "antioch/reaction_set.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace Antioch
+{
+
+  /*!
+   * Photolysis rate constants of all the photochemical reactions of a
+   * ReactionSet, for a photon flux shared by all of them.
+   *
+   * assemble() rebins the cross-sections of the photochemical
+   * reactions onto the abscissa of the flux and stores them, multiplied
+   * by the bins widths, as the rows of a dense n_photochemical_reactions()
+   * x n_bins() matrix \f$A\f$:
+   * \f[
+   *    A_{pi} = \sigma_p(\lambda_i) (\lambda_{i+1} - \lambda_i)
+   * \f]
+   * with a zero last column (right stairs, as PhotochemicalRate). The
+   * rate constants of all the photochemical reactions are then one
+   * matrix-vector product \f$k = A \phi\f$, and those of many cells
+   * sharing the flux abscissa one matrix-matrix product. Cross-sections
+   * are zero outside of their wavelength grid, only the non-zero range
+   * of each row is visited.
+   *
+   * The products are plain loops, the tree has no BLAS dependency.
+   *
+   * Only elementary and duplicate reactions whose rate constants are
+   * all photochemical are supported, the rate constants of a duplicate
+   * reaction share its row.
+   *
+   * The ReactionSet is not copied: any modification of the reaction set
+   * or of the cross-sections (see PhotochemicalRate::parameter_version())
+   * requires a call to assemble() before the next evaluation, as does a
+   * new flux abscissa.
+   */
+  template<typename CoeffType=double>
+  class PhotolysisRates
+  {
+  public:
+
+    //! Constructor, finds the photochemical reactions of \p reaction_set.
+    /*!
+     * The matrix is empty until the first call to assemble(), which
+     * also finds the photochemical reactions again if the reaction set
+     * was modified.
+     */
+    PhotolysisRates( const ReactionSet<CoeffType>& reaction_set );
+
+    ~PhotolysisRates();
+
+    //! (Re)builds the cross-sections matrix on the abscissa of \p pf
+    /*!
+     * Nothing is done if neither the reaction set, the cross-sections
+     * nor the abscissa of \p pf changed since the last call, see
+     * ParticleFlux::abscissa_version(), so it can be called before
+     * every evaluation.
+     */
+    void assemble( const ParticleFlux<std::vector<CoeffType> >& pf );
+
+    //! (Re)builds the cross-sections matrix on the wavelength grid \p lambda, sorted in increasing order
+    void assemble( const std::vector<CoeffType>& lambda );
+
+    //! \returns the number of photochemical reactions.
+    unsigned int n_photochemical_reactions() const;
+
+    //! \returns the indices of the photochemical reactions in the reaction set.
+    const std::vector<unsigned int>& photochemical_reactions() const;
+
+    //! \returns the size of the wavelength grid of the last assemble()
+    unsigned int n_bins() const;
+
+    //! Cross-sections times bins widths, row major n_photochemical_reactions() x n_bins() matrix
+    const std::vector<CoeffType>& cross_section_matrix() const;
+
+    //! Rate constants of the photochemical reactions for the flux of \p pf
+    /*!
+     * \p pf must have the abscissa of the last assemble(), \p k is of
+     * size n_photochemical_reactions(), in the order of photochemical_reactions().
+     */
+    void compute_photolysis_rates( const ParticleFlux<std::vector<CoeffType> >& pf,
+                                   std::vector<CoeffType>& k ) const;
+
+    //! Rate constants of the photochemical reactions, \p flux of size n_bins()
+    void compute_photolysis_rates( const std::vector<CoeffType>& flux,
+                                   std::vector<CoeffType>& k ) const;
+
+    //! Rate constants of the photochemical reactions, on \p n_cells cells
+    /*!
+     * Arrays are stored cells contiguous: the flux of bin i in cell c
+     * is flux[i*n_cells + c], the rate constant of the photochemical
+     * reaction p in cell c is k[p*n_cells + c].
+     */
+    void compute_batch_photolysis_rates( unsigned int n_cells,
+                                         const std::vector<CoeffType>& flux,
+                                         std::vector<CoeffType>& k ) const;
+
+    //! Rates of progress of the photochemical reactions
+    /*!
+     * The rates of progress are stored at the reaction indices in
+     * \p net_reaction_rates, which is of size ReactionSet::n_reactions().
+     * The other reactions are left untouched. The rate constants are
+     * kept in a member buffer, concurrent evaluations need one
+     * PhotolysisRates each.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const ParticleFlux<std::vector<CoeffType> >& pf,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates );
+
+  private:
+
+    PhotolysisRates();
+
+    //! Lists the photochemical reactions of the reaction set
+    void find_photochemical_reactions();
+
+    //! Sum of the PhotochemicalRate::parameter_version() of the photochemical reactions
+    unsigned long cross_sections_version() const;
+
+    //! Errors out if the reaction set or the cross-sections changed since the last assemble()
+    void check_version() const;
+
+    //! Cells per block of the batch product
+    static unsigned int cells_block();
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    std::vector<unsigned int> _photochemical_reactions;
+
+    unsigned int _n_bins;
+
+    //! n_photochemical_reactions() x n_bins(), row major
+    std::vector<CoeffType> _cross_sections;
+
+    //! non-zero columns of row p are _row_begin[p] to _row_end[p]
+    std::vector<unsigned int> _row_begin;
+    std::vector<unsigned int> _row_end;
+
+    unsigned int _assembled_version;
+
+    //! cross_sections_version() at the last assemble()
+    unsigned long _cross_sections_version;
+
+    //! ParticleFlux::abscissa_version() of the last assemble(), 0 if none
+    unsigned long _abscissa_version;
+
+    SigmaBinConverter<std::vector<CoeffType> > _converter;
+
+    //! Rate constants buffer of compute_reaction_rates()
+    std::vector<CoeffType> _k;
+
+    const CoeffType _P0_R;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  PhotolysisRates<CoeffType>::PhotolysisRates( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set(reaction_set),
+      _n_bins(0),
+      _assembled_version(reaction_set.parameter_version()),
+      _cross_sections_version(0),
+      _abscissa_version(0),
+      _P0_R(1.0e5/Constants::R_universal<CoeffType>()) //SI
+  {
+    this->find_photochemical_reactions();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  PhotolysisRates<CoeffType>::~PhotolysisRates()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int PhotolysisRates<CoeffType>::n_photochemical_reactions() const
+  {
+    return _photochemical_reactions.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& PhotolysisRates<CoeffType>::photochemical_reactions() const
+  {
+    return _photochemical_reactions;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int PhotolysisRates<CoeffType>::n_bins() const
+  {
+    return _n_bins;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& PhotolysisRates<CoeffType>::cross_section_matrix() const
+  {
+    return _cross_sections;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int PhotolysisRates<CoeffType>::cells_block()
+  {
+    return 64;
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::find_photochemical_reactions()
+  {
+    _photochemical_reactions.clear();
+
+    for(unsigned int rxn = 0; rxn < _reaction_set.n_reactions(); rxn++)
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+        unsigned int n_photo = 0;
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          {
+            if(reaction.forward_rate(ir).type() == KineticsModel::PHOTOCHEM)
+              n_photo++;
+          }
+
+        if(n_photo == 0)
+          continue;
+
+        if(n_photo != reaction.n_rate_constants() ||
+           (reaction.type() != ReactionType::ELEMENTARY && reaction.type() != ReactionType::DUPLICATE))
+          antioch_not_implemented_msg("Only elementary and duplicate reactions with photochemical rate constants only are supported, reaction " + reaction.equation());
+
+        _photochemical_reactions.push_back(rxn);
+      }
+
+    _row_begin.assign(_photochemical_reactions.size(),0);
+    _row_end.assign(_photochemical_reactions.size(),0);
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned long PhotolysisRates<CoeffType>::cross_sections_version() const
+  {
+    // each version only increases, so does their sum
+    unsigned long version = 0;
+
+    for(unsigned int p = 0; p < _photochemical_reactions.size(); p++)
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(_photochemical_reactions[p]);
+
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          version += static_cast<const PhotochemicalRate<CoeffType>&>(reaction.forward_rate(ir)).parameter_version();
+      }
+
+    return version;
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::check_version() const
+  {
+    if(_reaction_set.parameter_version() != _assembled_version)
+      antioch_error_msg("The reaction set was modified after the photolysis rates were assembled, assemble() must be called again.");
+
+    if(this->cross_sections_version() != _cross_sections_version)
+      antioch_error_msg("A cross-section was modified after the photolysis rates were assembled, assemble() must be called again.");
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::assemble( const ParticleFlux<std::vector<CoeffType> >& pf )
+  {
+    // the reaction set is checked first, the photochemical reactions may have changed
+    if(_abscissa_version == pf.abscissa_version() &&
+       _assembled_version == _reaction_set.parameter_version() &&
+       _cross_sections_version == this->cross_sections_version())
+      return;
+
+    this->assemble(pf.abscissa());
+
+    _abscissa_version = pf.abscissa_version();
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::assemble( const std::vector<CoeffType>& lambda )
+  {
+    antioch_assert_greater(lambda.size(),1);
+
+    for(unsigned int i = 1; i < lambda.size(); i++)
+      {
+        if(lambda[i] < lambda[i-1])
+          antioch_error_msg("The wavelength grid must be sorted in increasing order, value " << i << " is not.");
+      }
+
+    if(_assembled_version != _reaction_set.parameter_version())
+      this->find_photochemical_reactions();
+
+    const unsigned int n_photo = _photochemical_reactions.size();
+
+    _n_bins = lambda.size();
+    _cross_sections.assign(n_photo * _n_bins, 0);
+    _abscissa_version = 0;
+
+    std::vector<CoeffType> sigma(_n_bins);
+
+    for(unsigned int p = 0; p < n_photo; p++)
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(_photochemical_reactions[p]);
+        CoeffType * row = &_cross_sections[p * _n_bins];
+
+        for(unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++)
+          {
+            const PhotochemicalRate<CoeffType>& rate =
+              static_cast<const PhotochemicalRate<CoeffType>&>(reaction.forward_rate(ir));
+
+            _converter.y_on_custom_grid(rate.lambda_grid(), rate.cross_section(), lambda, sigma);
+
+            for(unsigned int i = 0; i < _n_bins - 1; i++) // right stairs, last one = 0
+              row[i] += sigma[i] * (lambda[i+1] - lambda[i]);
+          }
+
+        unsigned int begin = 0;
+        unsigned int end   = _n_bins - 1;
+        while(begin < end && row[begin] == 0)
+          begin++;
+        while(end > begin && row[end - 1] == 0)
+          end--;
+
+        _row_begin[p] = begin;
+        _row_end[p]   = end;
+      }
+
+    _assembled_version = _reaction_set.parameter_version();
+    _cross_sections_version = this->cross_sections_version();
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::compute_photolysis_rates( const ParticleFlux<std::vector<CoeffType> >& pf,
+                                                             std::vector<CoeffType>& k ) const
+  {
+    if(pf.abscissa_version() != _abscissa_version)
+      antioch_error_msg("The particle flux abscissa differs from the assembled one, assemble() must be called again.");
+
+    this->compute_photolysis_rates(pf.flux(), k);
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::compute_photolysis_rates( const std::vector<CoeffType>& flux,
+                                                             std::vector<CoeffType>& k ) const
+  {
+    antioch_assert_equal_to( flux.size(), this->n_bins() );
+    antioch_assert_equal_to( k.size(), this->n_photochemical_reactions() );
+
+    this->check_version();
+
+    for(unsigned int p = 0; p < _photochemical_reactions.size(); p++)
+      {
+        const CoeffType * row = &_cross_sections[p * _n_bins];
+
+        CoeffType kp = 0;
+        for(unsigned int i = _row_begin[p]; i < _row_end[p]; i++)
+          kp += row[i] * flux[i];
+
+        k[p] = kp;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void PhotolysisRates<CoeffType>::compute_batch_photolysis_rates( unsigned int n_cells,
+                                                                   const std::vector<CoeffType>& flux,
+                                                                   std::vector<CoeffType>& k ) const
+  {
+    antioch_assert_equal_to( flux.size(), this->n_bins() * n_cells );
+    antioch_assert_equal_to( k.size(), this->n_photochemical_reactions() * n_cells );
+
+    this->check_version();
+
+    std::fill(k.begin(), k.end(), CoeffType(0));
+
+    // blocks of cells, so that the flux block stays in cache
+    // while all the rows go through it
+    for(unsigned int c0 = 0; c0 < n_cells; c0 += cells_block())
+      {
+        const unsigned int c1 = std::min(n_cells, c0 + cells_block());
+
+        for(unsigned int p = 0; p < _photochemical_reactions.size(); p++)
+          {
+            const CoeffType * row = &_cross_sections[p * _n_bins];
+            CoeffType * kp = &k[p * n_cells];
+
+            for(unsigned int i = _row_begin[p]; i < _row_end[p]; i++)
+              {
+                const CoeffType a = row[i];
+                const CoeffType * flux_i = &flux[i * n_cells];
+
+                for(unsigned int c = c0; c < c1; c++)
+                  kp[c] += a * flux_i[c];
+              }
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void PhotolysisRates<CoeffType>::compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const ParticleFlux<std::vector<CoeffType> >& pf,
+                                                           const VectorStateType& molar_densities,
+                                                           const VectorStateType& h_RT_minus_s_R,
+                                                           VectorReactionsType& net_reaction_rates )
+  {
+    antioch_assert_equal_to( net_reaction_rates.size(), _reaction_set.n_reactions() );
+
+    _k.resize(_photochemical_reactions.size());
+    this->compute_photolysis_rates(pf, _k);
+
+    const StateType P0_RT = _P0_R/conditions.T();
+
+    for(unsigned int p = 0; p < _photochemical_reactions.size(); p++)
+      {
+        const unsigned int rxn = _photochemical_reactions[p];
+        const StateType kfwd = Antioch::constant_clone(P0_RT, _k[p]);
+
+        net_reaction_rates[rxn] = _reaction_set.reaction(rxn).rate_of_progress_from_kfwd(kfwd, molar_densities, P0_RT, h_RT_minus_s_R);
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_PHOTOLYSIS_RATES_H
@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_RATE_COEFFICIENT_CACHE_H
+#define ANTIOCH_RATE_COEFFICIENT_CACHE_H
+
+// Antioch
+#include "antioch/metaprogramming.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+  template<typename CoeffType>
+  class CompiledReactionSet;
+
+  template<typename CoeffType>
+  class TabulatedRateCoefficients;
+
+  //! Temperature-only quantities of a CompiledReactionSet evaluation
+  /*! The forward rate constants without their \f$[M]\f$ dependence, the
+   *  high pressure limits and the Troe \f$F_{\text{cent}}\f$ of the falloffs,
+   *  and the equilibrium constants only depend on the temperature. They are
+   *  kept here, with their temperature derivatives when the derivatives
+   *  were requested, and reused by the next evaluation at the same
+   *  temperature, e.g. within Newton iterations on the species at
+   *  frozen temperature.
+   *
+   *  The equilibrium constants are computed from the
+   *  \f$\frac{h}{RT} - \frac{s}{R}\f$ given at the first evaluation,
+   *  these are assumed to be functions of the temperature only.
+   *
+   *  The cache is invalidated when the temperature differs, when it was
+   *  filled for another CompiledReactionSet, and when the reaction set
+   *  parameters changed (see ReactionSet::parameter_version()).
+   *  invalidate() forces the next evaluation to recompute everything.
+   *
+   *  A cache is mutable data: each thread must use its own.
+   */
+  template<typename StateType>
+  class RateCoefficientCache
+  {
+  public:
+
+    RateCoefficientCache();
+
+    ~RateCoefficientCache();
+
+    //! Next evaluation recomputes all the quantities
+    void invalidate();
+
+    //! \returns true if the cache holds values
+    bool is_valid() const;
+
+    //! \returns the temperature of the cached values
+    const StateType& T() const;
+
+  private:
+
+    template<typename CoeffType>
+    friend class CompiledReactionSet;
+
+    template<typename CoeffType>
+    friend class TabulatedRateCoefficients;
+
+    //! true if the values of \p owner at \p T, with derivatives if \p derivatives, are stored
+    bool holds( const void* owner, const StateType& T, unsigned int version, bool derivatives ) const;
+
+    bool _valid;
+
+    bool _derivatives;
+
+    //! CompiledReactionSet the values were computed for
+    const void* _owner;
+
+    unsigned int _version;
+
+    StateType _T;
+
+    //! sum of the rate constants of each reaction
+    std::vector<StateType> _k;
+    std::vector<StateType> _dk_dT;
+
+    //! high pressure limits, Lindemann then Troe falloffs
+    std::vector<StateType> _kinf;
+    std::vector<StateType> _dkinf_dT;
+
+    //! Troe falloffs \f$F_{\text{cent}}\f$
+    std::vector<StateType> _Fcent;
+    std::vector<StateType> _dFcent_dT;
+
+    std::vector<StateType> _keq;
+    std::vector<StateType> _dkeq_dT;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename StateType>
+  inline
+  RateCoefficientCache<StateType>::RateCoefficientCache()
+    : _valid(false),
+      _derivatives(false),
+      _owner(NULL),
+      _version(0)
+  {
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  RateCoefficientCache<StateType>::~RateCoefficientCache()
+  {
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  void RateCoefficientCache<StateType>::invalidate()
+  {
+    _valid = false;
+  }
+
+  template<typename StateType>
+  inline
+  bool RateCoefficientCache<StateType>::is_valid() const
+  {
+    return _valid;
+  }
+
+  template<typename StateType>
+  inline
+  const StateType& RateCoefficientCache<StateType>::T() const
+  {
+    return _T;
+  }
+
+  template<typename StateType>
+  inline
+  bool RateCoefficientCache<StateType>::holds( const void* owner, const StateType& T, unsigned int version, bool derivatives ) const
+  {
+    return _valid &&
+           _owner == owner &&
+           _version == version &&
+           (_derivatives || !derivatives) &&
+           Antioch::conjunction(T == _T);
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_RATE_COEFFICIENT_CACHE_H
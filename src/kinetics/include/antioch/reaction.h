@@ -147,6 +147,10 @@ namespace Antioch
      */
     void set_maximum_rate( const CoeffType max_rate);
 
+    /*! \return the maximum reaction rate.
+     */
+    CoeffType maximum_rate() const;
+
     //! Model of kinetics.
     KineticsModel::KineticsModel kinetics_model() const;
 
@@ -293,6 +297,13 @@ namespace Antioch
                                         const StateType& P0_RT,
                                         const VectorStateType& h_RT_minus_s_R) const;
 
+    //! Rate of progress given the forward rate coefficient \p kfwd
+    template <typename StateType, typename VectorStateType>
+    StateType rate_of_progress_from_kfwd( const StateType& kfwd,
+                                          const VectorStateType& molar_densities,
+                                          const StateType& P0_RT,
+                                          const VectorStateType& h_RT_minus_s_R) const;
+
     // Deprecated API for backwards compatibility
     template <typename StateType, typename VectorStateType>
     StateType compute_rate_of_progress( const VectorStateType& molar_densities,
@@ -448,6 +459,13 @@ namespace Antioch
     _max_rate = max_rate;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  CoeffType Reaction<CoeffType,VectorCoeffType>::maximum_rate() const
+  {
+    return _max_rate;
+  }
+
   template<typename CoeffType,typename VectorCoeffType>
   inline
   KineticsModel::KineticsModel Reaction<CoeffType,VectorCoeffType>::kinetics_model() const
@@ -989,6 +1007,7 @@ namespace Antioch
         {
           (static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
         }
+        break;
 
       case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
         {
@@ -1039,9 +1058,19 @@ namespace Antioch
                                                            const StateType& P0_RT,
                                                            const VectorStateType& h_RT_minus_s_R) const
   {
-    using std::abs;
-
     StateType kfwd = this->compute_forward_rate_coefficient(molar_densities,conditions);
+
+    return this->rate_of_progress_from_kfwd(kfwd, molar_densities, P0_RT, h_RT_minus_s_R);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::rate_of_progress_from_kfwd( const StateType& kfwd,
+                                                                             const VectorStateType& molar_densities,
+                                                                             const StateType& P0_RT,
+                                                                             const VectorStateType& h_RT_minus_s_R) const
+  {
     if (has_nan(kfwd))
       antioch_error();
     antioch_assert(!has_nan(kfwd));
@@ -1157,7 +1186,7 @@ namespace Antioch
             this->reactant_partial_order(ro));
 
         const StateType dval =
-          ( static_cast<CoeffType>(this->reactant_stoichiometric_coefficient(ro))*
+          ( this->reactant_partial_order(ro)*
             ant_pow( molar_densities[this->reactant_id(ro)],
               this->reactant_partial_order(ro) - 1)
             );
@@ -1235,7 +1264,7 @@ namespace Antioch
               this->product_partial_order(po));
 
           const StateType dval =
-            ( static_cast<CoeffType>(this->product_stoichiometric_coefficient(po))*
+            ( this->product_partial_order(po)*
               ant_pow( molar_densities[this->product_id(po)],
               this->product_partial_order(po) - 1)
               );
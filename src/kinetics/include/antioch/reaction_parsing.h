@@ -82,6 +82,8 @@ namespace Antioch
         {
           reaction = new FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
         }
+        break;
+
       case(ReactionType::TROE_FALLOFF):
         {
           reaction = new FalloffReaction<CoeffType,TroeFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
@@ -92,6 +94,8 @@ namespace Antioch
         {
           reaction = new FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
         }
+        break;
+
       case(ReactionType::TROE_FALLOFF_THREE_BODY):
         {
           reaction = new FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
@@ -39,6 +39,14 @@
 #include "antioch/falloff_threebody_reaction.h"
 #include "antioch/lindemann_falloff.h"
 #include "antioch/troe_falloff.h"
+#include "antioch/constant_rate.h"
+#include "antioch/hercourtessen_rate.h"
+#include "antioch/berthelot_rate.h"
+#include "antioch/arrhenius_rate.h"
+#include "antioch/berthelothercourtessen_rate.h"
+#include "antioch/kooij_rate.h"
+#include "antioch/vanthoff_rate.h"
+#include "antioch/stoichiometric_matrix.h"
 #include "antioch/string_utils.h"
 
 // C++
@@ -47,6 +55,8 @@
 #include <iomanip>
 #include <vector>
 #include <limits>
+#include <atomic>
+#include <mutex>
 
 namespace Antioch
 {
@@ -54,6 +64,12 @@ namespace Antioch
   /*!
    * This class encapsulates all the reaction mechanisms considered in a
    * chemical nonequilibrium simulation.
+   *
+   * The reactions are grouped by reaction type and kinetics model of
+   * their rate constants. compute_reaction_rates() evaluates each group
+   * in its own loop, with the type and model resolved once per group
+   * instead of once per reaction. The rates are still stored at the
+   * reaction indices.
    */
   template<typename CoeffType=double>
   class ReactionSet
@@ -98,6 +114,27 @@ namespace Antioch
     template <typename ParamType>
     void set_parameter_of_reaction(const std::string & reaction_id, const std::vector<std::string> & keywords, ParamType value);
 
+    //! Counter of the modifications of the reactions
+    //
+    // Incremented whenever a reaction is added or removed, or a
+    // parameter is changed through set_parameter_of_reaction(),
+    // values cached from the reaction parameters (e.g. by a
+    // CompiledReactionSet) are stale when it differs.
+    unsigned int parameter_version() const;
+
+    //! Flags a modification of the reactions
+    //
+    // To be called after modifying a reaction through the writeable
+    // reaction() accessor, the stoichiometric matrix and the reactions
+    // groups are rebuilt on their next use.
+    void parameters_changed();
+
+    //! \returns the number of groups of reactions of the same type and kinetics model
+    unsigned int n_reaction_groups() const;
+
+    //! \returns the reactions of group \p g, in increasing order
+    const std::vector<unsigned int>& reaction_group(unsigned int g) const;
+
     //! \return a parameter of a reaction
     //
     // in charge of the human-to-antioch translation
@@ -105,6 +142,32 @@ namespace Antioch
 
     const ChemicalMixture<CoeffType>& chemical_mixture() const;
 
+    //! \returns the net stoichiometric matrix of the reactions.
+    //
+    // It is rebuilt on first use after a reaction was added or
+    // removed, or parameters_changed() was called.
+    const StoichiometricMatrix<CoeffType>& stoichiometric_matrix() const;
+
+    //! Compute the equilibrium constants of all the reactions
+    /*!
+     * \f$\ln K_r = \gamma_r \ln\left(\frac{P_0}{RT}\right)
+     *    - \sum_s \nu_{sr} \left(\frac{h_s}{RT} - \frac{s_s}{R}\right)\f$,
+     * the sum is one sparse product by the stoichiometric matrix for
+     * all the reactions.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_equilibrium_constants( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                        const VectorStateType& h_RT_minus_s_R,
+                                        VectorReactionsType& keq ) const;
+
+    //! Compute the equilibrium constants of all the reactions and their temperature derivatives
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_equilibrium_constants_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const VectorStateType& h_RT_minus_s_R,
+                                                   const VectorStateType& dh_RT_minus_s_R_dT,
+                                                   VectorReactionsType& keq,
+                                                   VectorReactionsType& dkeq_dT ) const;
+
     //! Compute the rates of progress for each reaction
     template <typename StateType, typename VectorStateType, typename VectorReactionsType>
     void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
@@ -178,10 +241,72 @@ namespace Antioch
     // This function is used for both getter and setter.
     void find_chemical_process_parameter(ReactionType::Parameters paramChem ,const std::vector<std::string> & keywords, unsigned int & species) const;
 
+    //! Reactions of the same type whose rate constants share a kinetics model
+    struct ReactionGroup
+    {
+      ReactionType::ReactionType type;
+      KineticsModel::KineticsModel kinetics;
+      //! false if the rate constants of a reaction mix models,
+      //! they are then dispatched by KineticsType
+      bool homogeneous;
+      std::vector<unsigned int> reactions;
+    };
+
+    //! Sorts the reactions in groups
+    void build_reaction_groups() const;
+
+    //! Rebuilds the stoichiometric matrix and the groups if the reactions changed
+    /*!
+     * Adding N reactions then costs a single rebuild. The rebuild is
+     * serialized, so that concurrent const evaluations are safe.
+     */
+    void update_structure() const;
+
+    //! Rates of progress of a group, dispatched on the reaction type
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_group_reaction_rates( const ReactionGroup& group,
+                                       const KineticsConditions<StateType,VectorStateType>& conditions,
+                                       const VectorStateType& molar_densities,
+                                       const StateType& P0_RT,
+                                       const VectorStateType& h_RT_minus_s_R,
+                                       VectorReactionsType& net_reaction_rates ) const;
+
+    //! Rates of progress of a group of \p ReactionClass, dispatched on the kinetics model
+    template <typename ReactionClass, typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_group_reaction_rates( const ReactionGroup& group,
+                                       const KineticsConditions<StateType,VectorStateType>& conditions,
+                                       const VectorStateType& molar_densities,
+                                       const StateType& P0_RT,
+                                       const VectorStateType& h_RT_minus_s_R,
+                                       VectorReactionsType& net_reaction_rates ) const;
+
+    //! Rates of progress of a group of \p ReactionClass with \p KineticsClass rate constants
+    template <typename ReactionClass, typename KineticsClass,
+              typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_group_reaction_rates( const ReactionGroup& group,
+                                       const KineticsConditions<StateType,VectorStateType>& conditions,
+                                       const VectorStateType& molar_densities,
+                                       const StateType& P0_RT,
+                                       const VectorStateType& h_RT_minus_s_R,
+                                       VectorReactionsType& net_reaction_rates ) const;
+
     const ChemicalMixture<CoeffType>& _chem_mixture;
 
     std::vector<Reaction<CoeffType>* > _reactions;
 
+    //! Rebuilt by update_structure()
+    mutable StoichiometricMatrix<CoeffType> _stoichiometric_matrix;
+
+    unsigned int _parameter_version;
+
+    //! Rebuilt by update_structure()
+    mutable std::vector<ReactionGroup> _reaction_groups;
+
+    //! true when the matrix and the groups must be rebuilt
+    mutable std::atomic<bool> _structure_outdated;
+
+    mutable std::mutex _structure_mutex;
+
     //! Scaling for equilibrium constant
     const CoeffType _P0_R;
 
@@ -211,6 +336,8 @@ namespace Antioch
     // and make sure it is initialized!
     _reactions.back()->initialize(_reactions.size() - 1);
 
+    this->parameters_changed();
+
     return;
   }
 
@@ -225,6 +352,8 @@ namespace Antioch
 
      //second, release the spot
      _reactions.erase(_reactions.begin() + nr);
+
+     this->parameters_changed();
   }
 
   template<typename CoeffType>
@@ -250,11 +379,109 @@ namespace Antioch
     return _chem_mixture;
   }
 
+  template<typename CoeffType>
+  inline
+  const StoichiometricMatrix<CoeffType>& ReactionSet<CoeffType>::stoichiometric_matrix() const
+  {
+    this->update_structure();
+    return _stoichiometric_matrix;
+  }
+
+
+  template<typename CoeffType>
+  inline
+  unsigned int ReactionSet<CoeffType>::parameter_version() const
+  {
+    return _parameter_version;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::parameters_changed()
+  {
+    _parameter_version++;
+
+    _structure_outdated.store(true, std::memory_order_release);
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::update_structure() const
+  {
+    if(!_structure_outdated.load(std::memory_order_acquire))
+      return;
+
+    std::lock_guard<std::mutex> lock(_structure_mutex);
+
+    // another thread may have rebuilt it meanwhile
+    if(!_structure_outdated.load(std::memory_order_relaxed))
+      return;
+
+    _stoichiometric_matrix.build(this->n_species(), _reactions);
+    this->build_reaction_groups();
+
+    _structure_outdated.store(false, std::memory_order_release);
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ReactionSet<CoeffType>::n_reaction_groups() const
+  {
+    this->update_structure();
+    return _reaction_groups.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& ReactionSet<CoeffType>::reaction_group(unsigned int g) const
+  {
+    this->update_structure();
+    antioch_assert_less(g, _reaction_groups.size());
+    return _reaction_groups[g].reactions;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::build_reaction_groups() const
+  {
+    _reaction_groups.clear();
+
+    for(unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
+      {
+        const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+        ReactionGroup key;
+        key.type        = reaction.type();
+        key.kinetics    = KineticsModel::CONSTANT;
+        key.homogeneous = (reaction.n_rate_constants() > 0);
+        if(key.homogeneous)
+          key.kinetics = reaction.forward_rate(0).type();
+        for(unsigned int ir = 1; ir < reaction.n_rate_constants(); ir++)
+          key.homogeneous = key.homogeneous && (reaction.forward_rate(ir).type() == key.kinetics);
+
+        // few groups, linear search
+        unsigned int g = 0;
+        for(; g < _reaction_groups.size(); g++)
+          {
+            const ReactionGroup& group = _reaction_groups[g];
+            if(group.type == key.type && group.homogeneous == key.homogeneous &&
+               (!key.homogeneous || group.kinetics == key.kinetics))
+              break;
+          }
+
+        if(g == _reaction_groups.size())
+          _reaction_groups.push_back(key);
+
+        _reaction_groups[g].reactions.push_back(rxn);
+      }
+  }
 
   template<typename CoeffType>
   inline
   ReactionSet<CoeffType>::ReactionSet( const ChemicalMixture<CoeffType>& chem_mixture )
     : _chem_mixture(chem_mixture),
+      _parameter_version(0),
+      _structure_outdated(true),
       _P0_R(1.0e5/Constants::R_universal<CoeffType>()) //SI
   {
     return;
@@ -269,6 +496,58 @@ namespace Antioch
     return;
   }
 
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_equilibrium_constants( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                              const VectorStateType& h_RT_minus_s_R,
+                                                              VectorReactionsType& keq ) const
+  {
+    antioch_assert_equal_to( keq.size(), this->n_reactions() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    // -ln(K) + gamma ln(P0/RT) = DrG0 = nu^T (h/RT - s/R)
+    this->stoichiometric_matrix().multiply_transpose( h_RT_minus_s_R, keq );
+
+    const StateType log_P0_RT = ant_log(_P0_R/conditions.T());
+    const std::vector<CoeffType>& gamma = _stoichiometric_matrix.gamma();
+
+    for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
+      {
+        keq[rxn] = ant_exp(gamma[rxn] * log_P0_RT - keq[rxn]);
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_equilibrium_constants_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                         const VectorStateType& h_RT_minus_s_R,
+                                                                         const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                         VectorReactionsType& keq,
+                                                                         VectorReactionsType& dkeq_dT ) const
+  {
+    antioch_assert_equal_to( dkeq_dT.size(), this->n_reactions() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+
+    this->compute_equilibrium_constants( conditions, h_RT_minus_s_R, keq );
+
+    // dK/dT = K (-gamma/T - nu^T d(h/RT - s/R)/dT)
+    this->stoichiometric_matrix().multiply_transpose( dh_RT_minus_s_R_dT, dkeq_dT );
+
+    const StateType & T = conditions.T();
+    const std::vector<CoeffType>& gamma = _stoichiometric_matrix.gamma();
+
+    for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
+      {
+        dkeq_dT[rxn] = keq[rxn] * (- gamma[rxn]/T - dkeq_dT[rxn]);
+      }
+
+    return;
+  }
+
   template<typename CoeffType>
   template<typename StateType, typename VectorStateType, typename VectorReactionsType>
   inline
@@ -288,15 +567,154 @@ namespace Antioch
     // useful constants
     const StateType P0_RT = _P0_R/conditions.T(); // used to transform equilibrium constant from pressure units
 
-    // compute reaction forward rates & other reaction-sized arrays
-    for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
+    this->update_structure();
+
+    // one loop per group of reactions
+    for (unsigned int g=0; g<_reaction_groups.size(); g++)
       {
-        net_reaction_rates[rxn] = this->reaction(rxn).compute_rate_of_progress(molar_densities, conditions, P0_RT, h_RT_minus_s_R);
+        this->compute_group_reaction_rates(_reaction_groups[g], conditions, molar_densities, P0_RT,
+                                           h_RT_minus_s_R, net_reaction_rates);
       }
 
     return;
   }
 
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_group_reaction_rates( const ReactionGroup& group,
+                                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                             const VectorStateType& molar_densities,
+                                                             const StateType& P0_RT,
+                                                             const VectorStateType& h_RT_minus_s_R,
+                                                             VectorReactionsType& net_reaction_rates ) const
+  {
+    switch(group.type)
+      {
+      case(ReactionType::ELEMENTARY):
+        this->compute_group_reaction_rates<ElementaryReaction<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::DUPLICATE):
+        this->compute_group_reaction_rates<DuplicateReaction<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::THREE_BODY):
+        this->compute_group_reaction_rates<ThreeBodyReaction<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+        this->compute_group_reaction_rates<FalloffReaction<CoeffType,LindemannFalloff<CoeffType> > >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::TROE_FALLOFF):
+        this->compute_group_reaction_rates<FalloffReaction<CoeffType,TroeFalloff<CoeffType> > >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+        this->compute_group_reaction_rates<FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> > >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        this->compute_group_reaction_rates<FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> > >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      default:
+        antioch_error();
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename ReactionClass, typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_group_reaction_rates( const ReactionGroup& group,
+                                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                             const VectorStateType& molar_densities,
+                                                             const StateType& P0_RT,
+                                                             const VectorStateType& h_RT_minus_s_R,
+                                                             VectorReactionsType& net_reaction_rates ) const
+  {
+    // mixed models and photochemical rates keep the KineticsType dispatch
+    if(!group.homogeneous)
+      {
+        this->compute_group_reaction_rates<ReactionClass, KineticsType<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        return;
+      }
+
+    switch(group.kinetics)
+      {
+      case(KineticsModel::CONSTANT):
+        this->compute_group_reaction_rates<ReactionClass, ConstantRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        this->compute_group_reaction_rates<ReactionClass, HercourtEssenRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        this->compute_group_reaction_rates<ReactionClass, BerthelotRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        this->compute_group_reaction_rates<ReactionClass, ArrheniusRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::BHE):
+        this->compute_group_reaction_rates<ReactionClass, BerthelotHercourtEssenRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::KOOIJ):
+        this->compute_group_reaction_rates<ReactionClass, KooijRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        this->compute_group_reaction_rates<ReactionClass, VantHoffRate<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+        break;
+
+      default:
+        this->compute_group_reaction_rates<ReactionClass, KineticsType<CoeffType> >
+          (group, conditions, molar_densities, P0_RT, h_RT_minus_s_R, net_reaction_rates);
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename ReactionClass, typename KineticsClass,
+           typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_group_reaction_rates( const ReactionGroup& group,
+                                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                             const VectorStateType& molar_densities,
+                                                             const StateType& P0_RT,
+                                                             const VectorStateType& h_RT_minus_s_R,
+                                                             VectorReactionsType& net_reaction_rates ) const
+  {
+    for (unsigned int i=0; i<group.reactions.size(); i++)
+      {
+        const unsigned int rxn = group.reactions[i];
+        const ReactionClass& reaction = static_cast<const ReactionClass&>(*_reactions[rxn]);
+
+        const StateType kfwd =
+          reaction.template compute_forward_rate_coefficient<StateType,VectorStateType,KineticsClass>(molar_densities, conditions);
+
+        net_reaction_rates[rxn] = reaction.rate_of_progress_from_kfwd(kfwd, molar_densities, P0_RT, h_RT_minus_s_R);
+      }
+  }
+
   template<typename CoeffType>
   template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
   inline
@@ -548,6 +966,8 @@ namespace Antioch
           antioch_error();
       }
 
+      this->parameters_changed();
+
   }
 
   template<typename CoeffType>
@@ -0,0 +1,454 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_SPARSE_KINETICS_EVALUATOR_H
+#define ANTIOCH_SPARSE_KINETICS_EVALUATOR_H
+
+// Antioch
+#include "antioch/metaprogramming.h"
+#include "antioch/reaction_set.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_workspace.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace Antioch
+{
+  //! Class to handle computing source terms and their sparse Jacobian for a given ReactionSet.
+  /*! The chemical Jacobian of a large mechanism is mostly zeros: a rate of
+   *  progress only depends on its reactants, on its products if the reaction is
+   *  reversible, and on its third bodies. The nonzero pattern of
+   *  \f$\partial \dot{\omega}_s/\partial X_t\f$ is built once at construction,
+   *  in compressed sparse row format (one row per species \f$s\f$), and only
+   *  those entries are computed and stored.
+   *
+   *  As the KineticsEvaluator, this class preallocates work arrays and so *must*
+   *  be created within a spawned thread, if running in a threaded environment.
+   *  The reaction set is compiled at construction (see CompiledReactionSet), and
+   *  compiled again by the next evaluation if it was modified since (see
+   *  ReactionSet::parameter_version()). The Jacobian pattern is then rebuilt.
+   *
+   *  Consecutive evaluations at the same temperature can reuse the rate
+   *  constants, falloff \f$F_{\text{cent}}\f$ and equilibrium constants of the
+   *  previous one, see set_rate_coefficient_caching() and RateCoefficientCache.
+   */
+  template<typename CoeffType=double, typename StateType=CoeffType>
+  class SparseKineticsEvaluator
+  {
+  public:
+
+    //! Constructor.  Requires a reaction set to be evaluated later,
+    //as well as an \p example instantiation of the data type to be
+    //used as inputs.
+    SparseKineticsEvaluator( const ReactionSet<CoeffType>& reaction_set,
+                             const StateType& example );
+
+    ~SparseKineticsEvaluator();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    unsigned int n_species() const;
+
+    unsigned int n_reactions() const;
+
+    //! Number of stored entries of the Jacobian
+    unsigned int n_jacobian_nonzeros() const;
+
+    //! Row \p s of the Jacobian is stored from jacobian_row_offsets()[s] to jacobian_row_offsets()[s+1]
+    const std::vector<unsigned int>& jacobian_row_offsets() const;
+
+    //! Species (column) of each stored entry of the Jacobian, sorted within a row
+    const std::vector<unsigned int>& jacobian_column_ids() const;
+
+    //! Reuse the temperature-only quantities when the temperature did not change, off by default
+    /*! The \f$\frac{h}{RT} - \frac{s}{R}\f$ given at an evaluation must
+     *  then only depend on the temperature. */
+    void set_rate_coefficient_caching( bool use_cache );
+
+    //! Next evaluation recomputes the temperature-only quantities
+    void invalidate_rate_coefficient_cache();
+
+    //! Compute species molar production/destruction rates per unit volume
+    /*! \f$ \left(mole/sec/m^3\right)\f$ */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mole_sources );
+
+    //! Compute species production/destruction rates and sparse derivatives
+    /*! \p dmole_dX_s is of size n_jacobian_nonzeros(), ordered as
+     *  jacobian_column_ids(). */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mole_sources,
+                                          VectorStateType& dmole_dT,
+                                          VectorStateType& dmole_dX_s );
+
+    //! Compute species production/destruction rates per unit volume
+    /*! \f$ \left(kg/sec/m^3\right)\f$ */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               VectorStateType& mass_sources );
+
+    //! Compute species production/destruction rates and sparse derivatives, in mass units
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mass_sources,
+                                          VectorStateType& dmass_dT,
+                                          VectorStateType& dmass_drho_s );
+
+  protected:
+
+    //! Jacobian pattern and assembly map
+    void build_jacobian_pattern();
+
+    //! Compiles the reaction set again if it was modified
+    void update_compiled_reaction_set();
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    CompiledReactionSet<CoeffType> _compiled;
+
+    std::vector<unsigned int> _jacobian_row_offsets;
+
+    std::vector<unsigned int> _jacobian_column_ids;
+
+    //! for each stoichiometric coefficient \f$\nu_{sr}\f$ and each
+    //! dependency of reaction \f$r\f$, position in the Jacobian values
+    std::vector<unsigned int> _assembly;
+
+    std::vector<StateType> _net_reaction_rates;
+
+    std::vector<StateType> _dnet_rate_dT;
+
+    std::vector<StateType> _dnet_rate_dX;
+
+    StateType _example;
+
+    //! work arrays of the compiled evaluations
+    KineticsWorkspace<StateType> _workspace;
+
+    RateCoefficientCache<StateType> _rate_coefficient_cache;
+
+    bool _use_rate_coefficient_cache;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename StateType>
+  inline
+  const ReactionSet<CoeffType>& SparseKineticsEvaluator<CoeffType,StateType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  unsigned int SparseKineticsEvaluator<CoeffType,StateType>::n_species() const
+  {
+    return _chem_mixture.n_species();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  unsigned int SparseKineticsEvaluator<CoeffType,StateType>::n_reactions() const
+  {
+    return _reaction_set.n_reactions();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  unsigned int SparseKineticsEvaluator<CoeffType,StateType>::n_jacobian_nonzeros() const
+  {
+    return _jacobian_column_ids.size();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const std::vector<unsigned int>& SparseKineticsEvaluator<CoeffType,StateType>::jacobian_row_offsets() const
+  {
+    return _jacobian_row_offsets;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const std::vector<unsigned int>& SparseKineticsEvaluator<CoeffType,StateType>::jacobian_column_ids() const
+  {
+    return _jacobian_column_ids;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  SparseKineticsEvaluator<CoeffType,StateType>::SparseKineticsEvaluator
+  ( const ReactionSet<CoeffType>& reaction_set,
+    const StateType& example )
+    : _reaction_set( reaction_set ),
+      _chem_mixture( reaction_set.chemical_mixture() ),
+      _compiled( reaction_set ),
+      _net_reaction_rates( reaction_set.n_reactions(), example ),
+      _dnet_rate_dT( reaction_set.n_reactions(), example ),
+      _dnet_rate_dX( _compiled.n_dependencies(), example ),
+      _example( example ),
+      _workspace( reaction_set, example ),
+      _use_rate_coefficient_cache( false )
+  {
+    this->build_jacobian_pattern();
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  SparseKineticsEvaluator<CoeffType,StateType>::~SparseKineticsEvaluator()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::set_rate_coefficient_caching( bool use_cache )
+  {
+    _use_rate_coefficient_cache = use_cache;
+    _rate_coefficient_cache.invalidate();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::invalidate_rate_coefficient_cache()
+  {
+    _rate_coefficient_cache.invalidate();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::update_compiled_reaction_set()
+  {
+    if( _compiled.compiled_version() != _reaction_set.parameter_version() )
+      {
+        _compiled.compile();
+        this->build_jacobian_pattern();
+
+        _net_reaction_rates.resize( _reaction_set.n_reactions(), _example );
+        _dnet_rate_dT.resize( _reaction_set.n_reactions(), _example );
+        _dnet_rate_dX.resize( _compiled.n_dependencies(), _example );
+
+        _rate_coefficient_cache.invalidate();
+      }
+
+    if( !_use_rate_coefficient_cache )
+      _rate_coefficient_cache.invalidate();
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::build_jacobian_pattern()
+  {
+    const StoichiometricMatrix<CoeffType>& nu = _reaction_set.stoichiometric_matrix();
+    const std::vector<unsigned int>& nu_offsets = nu.row_offsets();
+    const std::vector<unsigned int>& nu_reactions = nu.reaction_ids();
+
+    const std::vector<unsigned int>& dep_offsets = _compiled.dependency_offsets();
+    const std::vector<unsigned int>& dep_ids = _compiled.dependency_ids();
+
+    _jacobian_row_offsets.assign(1,0);
+    _jacobian_column_ids.clear();
+    _assembly.clear();
+
+    // row s is the union of the dependencies of the reactions species s takes part in
+    std::vector<unsigned int> columns;
+    for(unsigned int s = 0; s < this->n_species(); s++)
+      {
+        columns.clear();
+        for(unsigned int i = nu_offsets[s]; i < nu_offsets[s+1]; i++)
+          {
+            const unsigned int rxn = nu_reactions[i];
+            columns.insert(columns.end(), dep_ids.begin() + dep_offsets[rxn], dep_ids.begin() + dep_offsets[rxn+1]);
+          }
+
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+        const unsigned int row_begin = _jacobian_column_ids.size();
+        _jacobian_column_ids.insert(_jacobian_column_ids.end(), columns.begin(), columns.end());
+        _jacobian_row_offsets.push_back(_jacobian_column_ids.size());
+
+        for(unsigned int i = nu_offsets[s]; i < nu_offsets[s+1]; i++)
+          {
+            const unsigned int rxn = nu_reactions[i];
+            for(unsigned int k = dep_offsets[rxn]; k < dep_offsets[rxn+1]; k++)
+              {
+                _assembly.push_back(row_begin + (std::lower_bound(columns.begin(), columns.end(), dep_ids[k]) - columns.begin()));
+              }
+          }
+      }
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::compute_mole_sources( const KC& conditions,
+                                                                           const VectorStateType& molar_densities,
+                                                                           const VectorStateType& h_RT_minus_s_R,
+                                                                           VectorStateType& mole_sources )
+  {
+    this->update_compiled_reaction_set();
+
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                kinetics_conditions(conditions);
+
+    _compiled.compute_reaction_rates( _workspace, _rate_coefficient_cache, kinetics_conditions, molar_densities,
+                                      h_RT_minus_s_R, _net_reaction_rates );
+
+    this->_reaction_set.stoichiometric_matrix().multiply( _net_reaction_rates, mole_sources );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::compute_mass_sources( const KC& conditions,
+                                                                           const VectorStateType& molar_densities,
+                                                                           const VectorStateType& h_RT_minus_s_R,
+                                                                           VectorStateType& mass_sources )
+  {
+    // Quantities asserted in compute_mole_sources call
+    this->compute_mole_sources( conditions, molar_densities, h_RT_minus_s_R, mass_sources );
+
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        mass_sources[s] *= _chem_mixture.M(s);
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_derivs( const KC& conditions,
+                                                                                      const VectorStateType& molar_densities,
+                                                                                      const VectorStateType& h_RT_minus_s_R,
+                                                                                      const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                      VectorStateType& mole_sources,
+                                                                                      VectorStateType& dmole_dT,
+                                                                                      VectorStateType& dmole_dX_s )
+  {
+    this->update_compiled_reaction_set();
+
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dT.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dX_s.size(), this->n_jacobian_nonzeros() );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                                        kinetics_conditions(conditions);
+
+    _compiled.compute_reaction_rates_and_sparse_derivs( _workspace, _rate_coefficient_cache, kinetics_conditions,
+                                                        molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                        _net_reaction_rates,
+                                                        _dnet_rate_dT,
+                                                        _dnet_rate_dX );
+
+    const StoichiometricMatrix<CoeffType>& nu = this->_reaction_set.stoichiometric_matrix();
+    nu.multiply( _net_reaction_rates, mole_sources );
+    nu.multiply( _dnet_rate_dT, dmole_dT );
+
+    // dmole_dX_s[s][t] = sum_r nu_sr dR_r/dX_t, only on the pattern
+    const std::vector<unsigned int>& nu_reactions = nu.reaction_ids();
+    const std::vector<CoeffType>& nu_coeffs = nu.coefficients();
+    const std::vector<unsigned int>& dep_offsets = _compiled.dependency_offsets();
+
+    Antioch::set_zero(dmole_dX_s);
+
+    // the stored coefficients are in row order, as the assembly map
+    unsigned int a = 0;
+    for(unsigned int i = 0; i < nu_coeffs.size(); i++)
+      {
+        const unsigned int rxn = nu_reactions[i];
+        for(unsigned int k = dep_offsets[rxn]; k < dep_offsets[rxn+1]; k++)
+          {
+            dmole_dX_s[_assembly[a++]] += nu_coeffs[i] * _dnet_rate_dX[k];
+          }
+      }
+    antioch_assert_equal_to( a, _assembly.size() );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType, typename KC>
+  inline
+  void SparseKineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( const KC& conditions,
+                                                                                      const VectorStateType& molar_densities,
+                                                                                      const VectorStateType& h_RT_minus_s_R,
+                                                                                      const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                      VectorStateType& mass_sources,
+                                                                                      VectorStateType& dmass_dT,
+                                                                                      VectorStateType& dmass_drho_s )
+  {
+    // Asserts are in compute_mole_sources_and_derivs
+    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           mass_sources, dmass_dT, dmass_drho_s );
+
+    // Convert from mole units to mass units
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        mass_sources[s] *= _chem_mixture.M(s);
+        dmass_dT[s] *= _chem_mixture.M(s);
+
+        for (unsigned int i = _jacobian_row_offsets[s]; i < _jacobian_row_offsets[s+1]; i++)
+          {
+            dmass_drho_s[i] *= _chem_mixture.M(s)/_chem_mixture.M(_jacobian_column_ids[i]);
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_SPARSE_KINETICS_EVALUATOR_H
@@ -0,0 +1,520 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_STOICHIOMETRIC_MATRIX_H
+#define ANTIOCH_STOICHIOMETRIC_MATRIX_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/metaprogramming_decl.h"
+#include "antioch/reaction.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+
+  /*!
+   * Net stoichiometric matrix \f$\nu_{sr} = \nu''_{sr} - \nu'_{sr}\f$
+   * of a set of reactions, in compressed sparse row format
+   * with one row per species.
+   *
+   * The molar sources are then
+   * \f[
+   *   \dot{\omega}_s = \sum_r \nu_{sr} R_r
+   * \f]
+   * computed row by row: each species gathers the rates of the
+   * reactions it takes part in, no two rows write to the same
+   * location.
+   */
+  template<typename CoeffType=double>
+  class StoichiometricMatrix
+  {
+  public:
+
+    StoichiometricMatrix();
+
+    ~StoichiometricMatrix();
+
+    //! Builds the matrix from the reactions
+    void build( unsigned int n_species, const std::vector<Reaction<CoeffType>*>& reactions );
+
+    //! \returns the number of rows (species).
+    unsigned int n_species() const;
+
+    //! \returns the number of columns (reactions).
+    unsigned int n_reactions() const;
+
+    //! \returns the number of stored coefficients.
+    unsigned int n_nonzeros() const;
+
+    //! Row \p s is stored from row_offsets()[s] to row_offsets()[s+1]
+    const std::vector<unsigned int>& row_offsets() const;
+
+    //! Reaction index of each stored coefficient
+    const std::vector<unsigned int>& reaction_ids() const;
+
+    //! Stored net stoichiometric coefficients
+    const std::vector<CoeffType>& coefficients() const;
+
+    //! \f$ \nu_{sr}\f$, zero if not stored
+    CoeffType operator()( unsigned int s, unsigned int r ) const;
+
+    //! \f$\gamma_r = \sum_s \nu_{sr}\f$, change of the number of moles of each reaction
+    const std::vector<CoeffType>& gamma() const;
+
+    //! species_values = nu * reaction_values
+    /*!
+     * Sources of species, from the rates of progress of the reactions.
+     */
+    template <typename VectorReactionsType, typename VectorStateType>
+    void multiply( const VectorReactionsType& reaction_values,
+                   VectorStateType& species_values ) const;
+
+    //! species_values = nu * reaction_values, for a vector per reaction
+    /*!
+     * Jacobian of the species sources, from the derivatives
+     * of the rates of progress of the reactions.
+     */
+    template <typename MatrixReactionsType, typename MatrixStateType>
+    void multiply_rows( const MatrixReactionsType& reaction_values,
+                        MatrixStateType& species_values ) const;
+
+    //! reaction_values = nu^T * species_values
+    /*!
+     * Change of a species quantity through each reaction, e.g. the
+     * Gibbs free energy of reaction from the species ones.
+     */
+    template <typename VectorStateType, typename VectorReactionsType>
+    void multiply_transpose( const VectorStateType& species_values,
+                             VectorReactionsType& reaction_values ) const;
+
+    //! reaction_values = nu^T * species_values, on \p n_cells cells
+    /*!
+     * Same layout as multiply_cells().
+     */
+    template <typename VectorStateType, typename VectorReactionsType>
+    void multiply_transpose_cells( unsigned int n_cells,
+                                   const VectorStateType& species_values,
+                                   VectorReactionsType& reaction_values ) const;
+
+    //! species_values = nu * reaction_values, on \p n_cells cells
+    /*!
+     * Values are stored species (or reaction) major, cells contiguous:
+     * species_values[s*n_cells + c] is the value of species s in cell c.
+     */
+    template <typename VectorReactionsType, typename VectorStateType>
+    void multiply_cells( unsigned int n_cells,
+                         const VectorReactionsType& reaction_values,
+                         VectorStateType& species_values ) const;
+
+    //! reaction_values = nu^T * species_values, on the cells \p begin to \p end of \p n_cells cells
+    /*!
+     * \p species_values holds the \p n_cells cells, \p reaction_values
+     * only the end - begin cells of the range.
+     */
+    template <typename VectorStateType, typename VectorReactionsType>
+    void multiply_transpose_cells( unsigned int n_cells,
+                                   unsigned int begin, unsigned int end,
+                                   const VectorStateType& species_values,
+                                   VectorReactionsType& reaction_values ) const;
+
+    //! species_values = nu * reaction_values, on the cells \p begin to \p end of \p n_cells cells
+    /*!
+     * \p reaction_values only holds the end - begin cells of the range,
+     * \p species_values holds the \p n_cells cells and only the range
+     * is written.
+     */
+    template <typename VectorReactionsType, typename VectorStateType>
+    void multiply_cells( unsigned int n_cells,
+                         unsigned int begin, unsigned int end,
+                         const VectorReactionsType& reaction_values,
+                         VectorStateType& species_values ) const;
+
+  private:
+
+    unsigned int _n_species;
+
+    unsigned int _n_reactions;
+
+    std::vector<unsigned int> _row_offsets;
+
+    std::vector<unsigned int> _reaction_ids;
+
+    std::vector<CoeffType> _coefficients;
+
+    std::vector<CoeffType> _gamma;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  StoichiometricMatrix<CoeffType>::StoichiometricMatrix()
+    : _n_species(0),
+      _n_reactions(0),
+      _row_offsets(1,0)
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  StoichiometricMatrix<CoeffType>::~StoichiometricMatrix()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometricMatrix<CoeffType>::n_species() const
+  {
+    return _n_species;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometricMatrix<CoeffType>::n_reactions() const
+  {
+    return _n_reactions;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometricMatrix<CoeffType>::n_nonzeros() const
+  {
+    return _coefficients.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& StoichiometricMatrix<CoeffType>::row_offsets() const
+  {
+    return _row_offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& StoichiometricMatrix<CoeffType>::reaction_ids() const
+  {
+    return _reaction_ids;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& StoichiometricMatrix<CoeffType>::coefficients() const
+  {
+    return _coefficients;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType StoichiometricMatrix<CoeffType>::operator()( unsigned int s, unsigned int r ) const
+  {
+    antioch_assert_less(s, _n_species);
+    antioch_assert_less(r, _n_reactions);
+
+    for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+      {
+        if(_reaction_ids[i] == r)
+          return _coefficients[i];
+      }
+
+    return 0;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& StoichiometricMatrix<CoeffType>::gamma() const
+  {
+    return _gamma;
+  }
+
+  template<typename CoeffType>
+  inline
+  void StoichiometricMatrix<CoeffType>::build( unsigned int n_species,
+                                               const std::vector<Reaction<CoeffType>*>& reactions )
+  {
+    _n_species   = n_species;
+    _n_reactions = reactions.size();
+
+    // net coefficients, one row per species, reactions in increasing order
+    std::vector<std::vector<unsigned int> > ids(_n_species);
+    std::vector<std::vector<CoeffType> > coeffs(_n_species);
+
+    for(unsigned int rxn = 0; rxn < _n_reactions; rxn++)
+      {
+        const Reaction<CoeffType>& reaction = *reactions[rxn];
+
+        for(unsigned int r = 0; r < reaction.n_reactants(); r++)
+          {
+            const unsigned int s = reaction.reactant_id(r);
+            antioch_assert_less(s, _n_species);
+            if(ids[s].empty() || ids[s].back() != rxn)
+              {
+                ids[s].push_back(rxn);
+                coeffs[s].push_back(0);
+              }
+            coeffs[s].back() -= static_cast<CoeffType>(reaction.reactant_stoichiometric_coefficient(r));
+          }
+
+        for(unsigned int p = 0; p < reaction.n_products(); p++)
+          {
+            const unsigned int s = reaction.product_id(p);
+            antioch_assert_less(s, _n_species);
+            if(ids[s].empty() || ids[s].back() != rxn)
+              {
+                ids[s].push_back(rxn);
+                coeffs[s].push_back(0);
+              }
+            coeffs[s].back() += static_cast<CoeffType>(reaction.product_stoichiometric_coefficient(p));
+          }
+      }
+
+    _row_offsets.assign(1,0);
+    _reaction_ids.clear();
+    _coefficients.clear();
+    _gamma.assign(_n_reactions,0);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = 0; i < ids[s].size(); i++)
+          {
+            // species on both sides with the same coefficient
+            if(coeffs[s][i] == 0)
+              continue;
+
+            _reaction_ids.push_back(ids[s][i]);
+            _coefficients.push_back(coeffs[s][i]);
+            _gamma[ids[s][i]] += coeffs[s][i];
+          }
+        _row_offsets.push_back(_coefficients.size());
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorReactionsType, typename VectorStateType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply( const VectorReactionsType& reaction_values,
+                                                  VectorStateType& species_values ) const
+  {
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions);
+    antioch_assert_equal_to(species_values.size(), _n_species);
+
+    Antioch::set_zero(species_values);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            species_values[s] += _coefficients[i] * reaction_values[_reaction_ids[i]];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorStateType, typename VectorReactionsType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_transpose( const VectorStateType& species_values,
+                                                            VectorReactionsType& reaction_values ) const
+  {
+    antioch_assert_equal_to(species_values.size(), _n_species);
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions);
+
+    Antioch::set_zero(reaction_values);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            reaction_values[_reaction_ids[i]] += _coefficients[i] * species_values[s];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorStateType, typename VectorReactionsType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_transpose_cells( unsigned int n_cells,
+                                                                  const VectorStateType& species_values,
+                                                                  VectorReactionsType& reaction_values ) const
+  {
+    antioch_assert_equal_to(species_values.size(), _n_species * n_cells);
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions * n_cells);
+
+    Antioch::set_zero(reaction_values);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            const CoeffType nu = _coefficients[i];
+            const unsigned int rxn = _reaction_ids[i];
+
+            for(unsigned int c = 0; c < n_cells; c++)
+              {
+                reaction_values[rxn * n_cells + c] += nu * species_values[s * n_cells + c];
+              }
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename MatrixReactionsType, typename MatrixStateType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_rows( const MatrixReactionsType& reaction_values,
+                                                       MatrixStateType& species_values ) const
+  {
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions);
+    antioch_assert_equal_to(species_values.size(), _n_species);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        Antioch::set_zero(species_values[s]);
+
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            const CoeffType nu = _coefficients[i];
+            const unsigned int rxn = _reaction_ids[i];
+            antioch_assert_equal_to(reaction_values[rxn].size(), species_values[s].size());
+
+            for(unsigned int t = 0; t < species_values[s].size(); t++)
+              {
+                species_values[s][t] += nu * reaction_values[rxn][t];
+              }
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorReactionsType, typename VectorStateType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_cells( unsigned int n_cells,
+                                                        const VectorReactionsType& reaction_values,
+                                                        VectorStateType& species_values ) const
+  {
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions * n_cells);
+    antioch_assert_equal_to(species_values.size(), _n_species * n_cells);
+
+    Antioch::set_zero(species_values);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            const CoeffType nu = _coefficients[i];
+            const unsigned int rxn = _reaction_ids[i];
+
+            for(unsigned int c = 0; c < n_cells; c++)
+              {
+                species_values[s * n_cells + c] += nu * reaction_values[rxn * n_cells + c];
+              }
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorStateType, typename VectorReactionsType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_transpose_cells( unsigned int n_cells,
+                                                                  unsigned int begin, unsigned int end,
+                                                                  const VectorStateType& species_values,
+                                                                  VectorReactionsType& reaction_values ) const
+  {
+    const unsigned int m = end - begin;
+
+    antioch_assert_less_equal(end, n_cells);
+    antioch_assert_equal_to(species_values.size(), _n_species * n_cells);
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions * m);
+
+    Antioch::set_zero(reaction_values);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            const CoeffType nu = _coefficients[i];
+            const unsigned int rxn = _reaction_ids[i];
+
+            for(unsigned int c = 0; c < m; c++)
+              {
+                reaction_values[rxn * m + c] += nu * species_values[s * n_cells + begin + c];
+              }
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorReactionsType, typename VectorStateType>
+  inline
+  void StoichiometricMatrix<CoeffType>::multiply_cells( unsigned int n_cells,
+                                                        unsigned int begin, unsigned int end,
+                                                        const VectorReactionsType& reaction_values,
+                                                        VectorStateType& species_values ) const
+  {
+    const unsigned int m = end - begin;
+
+    antioch_assert_less_equal(end, n_cells);
+    antioch_assert_equal_to(reaction_values.size(), _n_reactions * m);
+    antioch_assert_equal_to(species_values.size(), _n_species * n_cells);
+
+    for(unsigned int s = 0; s < _n_species; s++)
+      {
+        for(unsigned int c = 0; c < m; c++)
+          Antioch::set_zero(species_values[s * n_cells + begin + c]);
+
+        for(unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++)
+          {
+            const CoeffType nu = _coefficients[i];
+            const unsigned int rxn = _reaction_ids[i];
+
+            for(unsigned int c = 0; c < m; c++)
+              {
+                species_values[s * n_cells + begin + c] += nu * reaction_values[rxn * m + c];
+              }
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_STOICHIOMETRIC_MATRIX_H
@@ -0,0 +1,629 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_TABULATED_RATE_COEFFICIENTS_H
+#define ANTIOCH_TABULATED_RATE_COEFFICIENTS_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/physical_constants.h"
+#include "antioch/temp_cache.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/rate_coefficient_cache.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Antioch
+{
+  //! Temperature-only quantities of a CompiledReactionSet, interpolated on a grid
+  /*!
+   * The quantities of a RateCoefficientCache (rate constants without
+   * \f$[M]\f$, falloff high pressure limits, Troe \f$F_{\text{cent}}\f$ and
+   * equilibrium constants) are tabulated once on a uniform grid in
+   * \f$x = 1/T\f$ between \f$T_{\min}\f$ and \f$T_{\max}\f$, then
+   * interpolated by cubic Hermite polynomials using the exact slopes
+   * at the nodes:
+   * \f[
+   *   f(x) = h_{00}(t) f_i + h_{10}(t) \Delta x f'_i + h_{01}(t) f_{i+1} + h_{11}(t) \Delta x f'_{i+1}
+   * \f]
+   * The logarithm of the quantities is interpolated (\f$\ln k\f$ is
+   * linear in \f$1/T\f$ for an Arrhenius rate), unless the quantity
+   * changes sign or vanishes on the range. The equilibrium constants
+   * are tabulated as \f$\ln K\f$ so they do not underflow.
+   *
+   * Each evaluation then costs one exponential per quantity, instead of
+   * the exponentials and powers of every kinetics and falloff model.
+   * The interpolation error is \f$O(\Delta x^4)\f$. Its constant depends
+   * on the fourth derivative of every kinetics, falloff and thermodynamics
+   * model, so no bound is derived: sampled_relative_error() is only the
+   * error measured at sample points between the nodes when tabulating.
+   *
+   * As the interpolated equilibrium constants are computed from the
+   * thermodynamics given to tabulate(), the
+   * \f$\frac{h}{RT} - \frac{s}{R}\f$ given to the evaluations are not used.
+   * The table is invalid once the reaction set is modified (see
+   * ReactionSet::parameter_version()), tabulate() must be called again.
+   */
+  template<typename CoeffType=double>
+  class TabulatedRateCoefficients
+  {
+  public:
+
+    //! Constructor, nothing is tabulated yet
+    TabulatedRateCoefficients( const CompiledReactionSet<CoeffType>& compiled );
+
+    ~TabulatedRateCoefficients();
+
+    //! Tabulates on \p n_intervals intervals between \p T_min and \p T_max
+    /*!
+     * \p thermo gives \f$\frac{h}{RT} - \frac{s}{R}\f$ and its derivative
+     * (CEAEvaluator, NASAEvaluator).
+     */
+    template <typename ThermoEvaluator>
+    void tabulate( const ThermoEvaluator& thermo,
+                   const CoeffType& T_min,
+                   const CoeffType& T_max,
+                   unsigned int n_intervals );
+
+    //! \returns true if tabulate() was called for the current reaction set parameters
+    bool is_tabulated() const;
+
+    CoeffType T_min() const;
+
+    CoeffType T_max() const;
+
+    //! Largest relative error of the tabulated quantities at the sample points
+    /*!
+     * Measured at a quarter, half and three quarters of each interval
+     * (the Hermite error term \f$t^2(1-t)^2\f$ peaks at the midpoint).
+     * This is not a bound, the error elsewhere in an interval can be
+     * larger where the fourth derivative varies.
+     */
+    CoeffType sampled_relative_error() const;
+
+    //! Fills \p cache by interpolation at \p T, with the temperature derivatives
+    /*!
+     * \p T must be within [T_min(), T_max()].
+     */
+    void interpolate( const CoeffType& T, RateCoefficientCache<CoeffType>& cache ) const;
+
+    //! Compute the rates of progress with the interpolated quantities
+    /*!
+     * Same as CompiledReactionSet::compute_reaction_rates(), \p cache is
+     * filled by interpolate() if it does not hold the temperature of
+     * \p conditions.
+     */
+    template <typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( RateCoefficientCache<CoeffType>& cache,
+                                 const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress and their sparse derivatives with the interpolated quantities
+    template <typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+    void compute_reaction_rates_and_sparse_derivs( RateCoefficientCache<CoeffType>& cache,
+                                                   const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                   const VectorStateType& molar_densities,
+                                                   const VectorStateType& h_RT_minus_s_R,
+                                                   const VectorStateType& dh_RT_minus_s_R_dT,
+                                                   VectorReactionsType& net_reaction_rates,
+                                                   VectorReactionsType& dnet_rate_dT,
+                                                   VectorDependenciesType& dnet_rate_dX ) const;
+
+  private:
+
+    TabulatedRateCoefficients();
+
+    //! Exact quantities at \p T, values and slopes with respect to 1/T
+    template <typename ThermoEvaluator>
+    void exact_values( const ThermoEvaluator& thermo, const CoeffType& T,
+                       RateCoefficientCache<CoeffType>& cache,
+                       std::vector<CoeffType>& values,
+                       std::vector<CoeffType>& slopes ) const;
+
+    //! Interval of a temperature and Hermite basis, with respect to x, in it
+    /*!
+     * The value of an entry is
+     * h[0] f_i + h[1] f'_i + h[2] f_{i+1} + h[3] f'_{i+1}, its slope the
+     * same with dh.
+     */
+    struct HermiteBasis
+    {
+      unsigned int interval;
+      CoeffType h[4];
+      CoeffType dh[4];
+    };
+
+    //! Basis at \p T
+    void hermite_basis( const CoeffType& T, HermiteBasis& basis ) const;
+
+    //! Interpolated value and slope of entry \p e, as stored (logarithm or not)
+    void interpolate_entry( unsigned int e,
+                            const HermiteBasis& basis,
+                            CoeffType& value,
+                            CoeffType& slope ) const;
+
+    //! Interpolated values and slopes of all the entries, as stored
+    void interpolate_entries( const CoeffType& T,
+                              std::vector<CoeffType>& values,
+                              std::vector<CoeffType>& slopes ) const;
+
+    //! Interpolated value and temperature derivative of entry \p e
+    void entry_value( unsigned int e,
+                      const HermiteBasis& basis,
+                      const CoeffType& dx_dT,
+                      CoeffType& value,
+                      CoeffType& dvalue_dT ) const;
+
+    //! Checks that interpolation at \p T is possible
+    void check_temperature( const CoeffType& T ) const;
+
+    const CompiledReactionSet<CoeffType>& _compiled;
+
+    unsigned int _version;
+
+    bool _tabulated;
+
+    //! entries are the reactions rate constants, the high pressure
+    //! limits, the Troe Fcent and the equilibrium constants
+    unsigned int _n_rates;
+    unsigned int _n_kinf;
+    unsigned int _n_Fcent;
+    unsigned int _n_entries;
+
+    CoeffType _T_min;
+    CoeffType _T_max;
+
+    //! grid in x = 1/T, from 1/T_max
+    CoeffType _x_min;
+    CoeffType _dx;
+    unsigned int _n_intervals;
+
+    //! node major, _values[i * _n_entries + e]
+    std::vector<CoeffType> _values;
+    //! slopes with respect to x
+    std::vector<CoeffType> _slopes;
+
+    //! logarithm of the absolute value stored, and its sign
+    std::vector<bool>      _log_scale;
+    std::vector<CoeffType> _signs;
+
+    CoeffType _sampled_relative_error;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  TabulatedRateCoefficients<CoeffType>::TabulatedRateCoefficients( const CompiledReactionSet<CoeffType>& compiled )
+    : _compiled(compiled),
+      _version(0),
+      _tabulated(false),
+      _n_rates(0),
+      _n_kinf(0),
+      _n_Fcent(0),
+      _n_entries(0),
+      _T_min(0),
+      _T_max(0),
+      _x_min(0),
+      _dx(0),
+      _n_intervals(0),
+      _sampled_relative_error(0)
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  TabulatedRateCoefficients<CoeffType>::~TabulatedRateCoefficients()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool TabulatedRateCoefficients<CoeffType>::is_tabulated() const
+  {
+    return _tabulated && _version == _compiled.reaction_set().parameter_version();
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType TabulatedRateCoefficients<CoeffType>::T_min() const
+  {
+    return _T_min;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType TabulatedRateCoefficients<CoeffType>::T_max() const
+  {
+    return _T_max;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType TabulatedRateCoefficients<CoeffType>::sampled_relative_error() const
+  {
+    return _sampled_relative_error;
+  }
+
+  template<typename CoeffType>
+  template<typename ThermoEvaluator>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::exact_values( const ThermoEvaluator& thermo, const CoeffType& T,
+                                                           RateCoefficientCache<CoeffType>& cache,
+                                                           std::vector<CoeffType>& values,
+                                                           std::vector<CoeffType>& slopes ) const
+  {
+    using std::log;
+
+    const ReactionSet<CoeffType>& reaction_set = _compiled.reaction_set();
+    const unsigned int n_species = reaction_set.n_species();
+
+    TempCache<CoeffType> temp_cache(T);
+    const KineticsConditions<CoeffType> conditions(T);
+
+    std::vector<CoeffType> h_RT_minus_s_R(n_species), dh_RT_minus_s_R_dT(n_species);
+    thermo.h_RT_minus_s_R(temp_cache, h_RT_minus_s_R);
+    thermo.dh_RT_minus_s_R_dT(temp_cache, dh_RT_minus_s_R_dT);
+
+    cache.invalidate();
+    _compiled.update_rate_coefficient_cache(conditions, h_RT_minus_s_R, &dh_RT_minus_s_R_dT, cache);
+
+    values.resize(_n_entries);
+    slopes.resize(_n_entries);
+
+    // d/dx = -T^2 d/dT
+    const CoeffType mT2 = - T * T;
+
+    unsigned int e = 0;
+    for(unsigned int i = 0; i < _n_rates; i++, e++)
+      {
+        values[e] = cache._k[i];
+        slopes[e] = mT2 * cache._dk_dT[i];
+      }
+    for(unsigned int i = 0; i < _n_kinf; i++, e++)
+      {
+        values[e] = cache._kinf[i];
+        slopes[e] = mT2 * cache._dkinf_dT[i];
+      }
+    for(unsigned int i = 0; i < _n_Fcent; i++, e++)
+      {
+        values[e] = cache._Fcent[i];
+        slopes[e] = mT2 * cache._dFcent_dT[i];
+      }
+
+    // ln(K) = gamma ln(P0/(RT)) - nu^T (h/RT - s/R), computed directly
+    std::vector<CoeffType> nu_h(_n_rates), nu_dh(_n_rates);
+    const StoichiometricMatrix<CoeffType>& nu = reaction_set.stoichiometric_matrix();
+    nu.multiply_transpose(h_RT_minus_s_R, nu_h);
+    nu.multiply_transpose(dh_RT_minus_s_R_dT, nu_dh);
+
+    const CoeffType log_P0_RT = log(CoeffType(1e5L) / (Constants::R_universal<CoeffType>() * T));
+    for(unsigned int i = 0; i < _n_rates; i++, e++)
+      {
+        values[e] = nu.gamma()[i] * log_P0_RT - nu_h[i];
+        slopes[e] = mT2 * (- nu.gamma()[i]/T - nu_dh[i]);
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename ThermoEvaluator>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::tabulate( const ThermoEvaluator& thermo,
+                                                       const CoeffType& T_min,
+                                                       const CoeffType& T_max,
+                                                       unsigned int n_intervals )
+  {
+    using std::abs;
+    using std::log;
+    using std::exp;
+
+    antioch_assert_greater(T_min, 0);
+    antioch_assert_greater(T_max, T_min);
+    antioch_assert_greater(n_intervals, 0);
+
+    if(_compiled.compiled_version() != _compiled.reaction_set().parameter_version())
+      antioch_error_msg("The reaction set was modified after it was compiled, compile() must be called again.");
+
+    _T_min       = T_min;
+    _T_max       = T_max;
+    _n_intervals = n_intervals;
+    _x_min       = 1/T_max;
+    _dx          = (1/T_min - 1/T_max) / n_intervals;
+
+    // sizes from one evaluation
+    RateCoefficientCache<CoeffType> cache;
+    {
+      std::vector<CoeffType> h(_compiled.n_species(), 0);
+      _compiled.update_rate_coefficient_cache(KineticsConditions<CoeffType>(T_max), h,
+                                              static_cast<const std::vector<CoeffType>*>(NULL), cache);
+      _n_rates   = cache._k.size();
+      _n_kinf    = cache._kinf.size();
+      _n_Fcent   = cache._Fcent.size();
+      _n_entries = 2 * _n_rates + _n_kinf + _n_Fcent;
+    }
+
+    const unsigned int n_nodes = n_intervals + 1;
+    _values.resize(n_nodes * _n_entries);
+    _slopes.resize(n_nodes * _n_entries);
+
+    std::vector<CoeffType> values, slopes;
+    for(unsigned int i = 0; i < n_nodes; i++)
+      {
+        // last node exactly at T_min
+        const CoeffType T = (i == n_intervals) ? T_min : 1/(_x_min + i * _dx);
+        this->exact_values(thermo, T, cache, values, slopes);
+        std::copy(values.begin(), values.end(), _values.begin() + i * _n_entries);
+        std::copy(slopes.begin(), slopes.end(), _slopes.begin() + i * _n_entries);
+      }
+
+    // logarithms where the quantity keeps its sign, ln(K) is already one
+    _log_scale.assign(_n_entries, true);
+    _signs.assign(_n_entries, 1);
+    for(unsigned int e = 0; e < _n_entries - _n_rates; e++)
+      {
+        const CoeffType first = _values[e];
+        _signs[e] = (first < 0) ? -1 : 1;
+        for(unsigned int i = 0; i < n_nodes; i++)
+          {
+            if(_values[i * _n_entries + e] * _signs[e] <= 0)
+              {
+                _log_scale[e] = false;
+                _signs[e] = 1;
+                break;
+              }
+          }
+
+        if(!_log_scale[e])
+          continue;
+
+        for(unsigned int i = 0; i < n_nodes; i++)
+          {
+            const unsigned int j = i * _n_entries + e;
+            _slopes[j] /= _values[j];
+            _values[j]  = log(abs(_values[j]));
+          }
+      }
+
+    _version   = _compiled.reaction_set().parameter_version();
+    _tabulated = true;
+
+    // worst case measured between the nodes
+    CoeffType max_error = 0;
+    std::vector<CoeffType> interpolated, dummy;
+    for(unsigned int i = 0; i < n_intervals; i++)
+      {
+        for(unsigned int q = 1; q < 4; q++)
+          {
+            const CoeffType T = 1/(_x_min + (i + CoeffType(q)/4) * _dx);
+
+            this->exact_values(thermo, T, cache, values, slopes);
+            this->interpolate_entries(T, interpolated, dummy);
+
+            for(unsigned int e = 0; e < _n_entries; e++)
+              {
+                CoeffType exact  = values[e];
+                CoeffType approx = interpolated[e];
+                if(e >= _n_entries - _n_rates)
+                  {
+                    // relative error of K from the error of ln(K)
+                    const CoeffType error = abs(exp(approx - exact) - 1);
+                    max_error = std::max(max_error, error);
+                    continue;
+                  }
+                if(_log_scale[e])
+                  approx = _signs[e] * exp(approx);
+
+                const CoeffType scale = std::max(abs(exact), std::numeric_limits<CoeffType>::min());
+                max_error = std::max(max_error, abs(approx - exact)/scale);
+              }
+          }
+      }
+
+    _sampled_relative_error = max_error;
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::check_temperature( const CoeffType& T ) const
+  {
+    if(!this->is_tabulated())
+      antioch_error_msg("The rate coefficients are not tabulated for the current reaction set, tabulate() must be called.");
+
+    if(T < _T_min || T > _T_max)
+      {
+        std::cerr << "Error: temperature " << T << " out of the tabulated range ["
+                  << _T_min << ", " << _T_max << "]" << std::endl;
+        antioch_error();
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::hermite_basis( const CoeffType& T, HermiteBasis& basis ) const
+  {
+    // interval and local coordinate
+    const CoeffType s = (1/T - _x_min) / _dx;
+    unsigned int i = (s > 0) ? static_cast<unsigned int>(s) : 0;
+    if(i >= _n_intervals)
+      i = _n_intervals - 1;
+    const CoeffType t = s - i;
+
+    // Hermite basis h00, h10, h01, h11 and derivatives, d/dx = 1/dx d/dt
+    const CoeffType t2 = t * t;
+    const CoeffType t3 = t2 * t;
+    basis.interval = i;
+    basis.h[0]  = 2*t3 - 3*t2 + 1;
+    basis.h[1]  = (t3 - 2*t2 + t) * _dx;
+    basis.h[2]  = - 2*t3 + 3*t2;
+    basis.h[3]  = (t3 - t2) * _dx;
+    basis.dh[0] = (6*t2 - 6*t) / _dx;
+    basis.dh[1] = 3*t2 - 4*t + 1;
+    basis.dh[2] = - basis.dh[0];
+    basis.dh[3] = 3*t2 - 2*t;
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::interpolate_entry( unsigned int e,
+                                                                const HermiteBasis& basis,
+                                                                CoeffType& value,
+                                                                CoeffType& slope ) const
+  {
+    const unsigned int j0 = basis.interval * _n_entries + e;
+    const unsigned int j1 = j0 + _n_entries;
+
+    value = basis.h[0]  * _values[j0] + basis.h[1]  * _slopes[j0] + basis.h[2]  * _values[j1] + basis.h[3]  * _slopes[j1];
+    slope = basis.dh[0] * _values[j0] + basis.dh[1] * _slopes[j0] + basis.dh[2] * _values[j1] + basis.dh[3] * _slopes[j1];
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::interpolate_entries( const CoeffType& T,
+                                                                  std::vector<CoeffType>& values,
+                                                                  std::vector<CoeffType>& slopes ) const
+  {
+    values.resize(_n_entries);
+    slopes.resize(_n_entries);
+
+    HermiteBasis basis;
+    this->hermite_basis(T, basis);
+
+    for(unsigned int e = 0; e < _n_entries; e++)
+      this->interpolate_entry(e, basis, values[e], slopes[e]);
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::entry_value( unsigned int e,
+                                                          const HermiteBasis& basis,
+                                                          const CoeffType& dx_dT,
+                                                          CoeffType& value,
+                                                          CoeffType& dvalue_dT ) const
+  {
+    using std::exp;
+
+    CoeffType stored, slope;
+    this->interpolate_entry(e, basis, stored, slope);
+
+    if(_log_scale[e])
+      {
+        value     = _signs[e] * exp(stored);
+        dvalue_dT = value * slope * dx_dT;
+      }
+    else
+      {
+        value     = stored;
+        dvalue_dT = slope * dx_dT;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::interpolate( const CoeffType& T, RateCoefficientCache<CoeffType>& cache ) const
+  {
+    this->check_temperature(T);
+
+    HermiteBasis basis;
+    this->hermite_basis(T, basis);
+
+    // straight into the cache, nothing is allocated once it is sized
+    cache._k.resize(_n_rates);
+    cache._dk_dT.resize(_n_rates);
+    cache._kinf.resize(_n_kinf);
+    cache._dkinf_dT.resize(_n_kinf);
+    cache._Fcent.resize(_n_Fcent);
+    cache._dFcent_dT.resize(_n_Fcent);
+    cache._keq.resize(_n_rates);
+    cache._dkeq_dT.resize(_n_rates);
+
+    // d/dT = -1/T^2 d/dx
+    const CoeffType dx_dT = - 1/(T*T);
+
+    unsigned int e = 0;
+    for(unsigned int i = 0; i < _n_rates; i++, e++)
+      this->entry_value(e, basis, dx_dT, cache._k[i], cache._dk_dT[i]);
+    for(unsigned int i = 0; i < _n_kinf; i++, e++)
+      this->entry_value(e, basis, dx_dT, cache._kinf[i], cache._dkinf_dT[i]);
+    for(unsigned int i = 0; i < _n_Fcent; i++, e++)
+      this->entry_value(e, basis, dx_dT, cache._Fcent[i], cache._dFcent_dT[i]);
+    for(unsigned int i = 0; i < _n_rates; i++, e++)
+      this->entry_value(e, basis, dx_dT, cache._keq[i], cache._dkeq_dT[i]);
+
+    // filled on behalf of the compiled set, which evaluates the rates
+    cache._owner       = &_compiled;
+    cache._T           = T;
+    cache._version     = _compiled.compiled_version();
+    cache._derivatives = true;
+    cache._valid       = true;
+  }
+
+  template<typename CoeffType>
+  template <typename VectorStateType, typename VectorReactionsType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::compute_reaction_rates( RateCoefficientCache<CoeffType>& cache,
+                                                                     const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                                     const VectorStateType& molar_densities,
+                                                                     const VectorStateType& h_RT_minus_s_R,
+                                                                     VectorReactionsType& net_reaction_rates ) const
+  {
+    if(!cache.holds(&_compiled, conditions.T(), _compiled.compiled_version(), true))
+      this->interpolate(conditions.T(), cache);
+
+    _compiled.compute_reaction_rates(cache, conditions, molar_densities, h_RT_minus_s_R, net_reaction_rates);
+  }
+
+  template<typename CoeffType>
+  template <typename VectorStateType, typename VectorReactionsType, typename VectorDependenciesType>
+  inline
+  void TabulatedRateCoefficients<CoeffType>::compute_reaction_rates_and_sparse_derivs( RateCoefficientCache<CoeffType>& cache,
+                                                                                       const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                                                       const VectorStateType& molar_densities,
+                                                                                       const VectorStateType& h_RT_minus_s_R,
+                                                                                       const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                       VectorReactionsType& net_reaction_rates,
+                                                                                       VectorReactionsType& dnet_rate_dT,
+                                                                                       VectorDependenciesType& dnet_rate_dX ) const
+  {
+    if(!cache.holds(&_compiled, conditions.T(), _compiled.compiled_version(), true))
+      this->interpolate(conditions.T(), cache);
+
+    _compiled.compute_reaction_rates_and_sparse_derivs(cache, conditions, molar_densities,
+                                                       h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                       net_reaction_rates, dnet_rate_dT, dnet_rate_dX);
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_TABULATED_RATE_COEFFICIENTS_H
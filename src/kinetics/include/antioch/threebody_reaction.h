@@ -74,8 +74,8 @@ namespace Antioch
 
     ~ThreeBodyReaction();
 
-    //!
-    template <typename StateType, typename VectorStateType>
+    //! \p KineticsClass is the type of the rate constants, KineticsType dispatches at each call
+    template <typename StateType, typename VectorStateType, typename KineticsClass = KineticsType<CoeffType> >
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions ) const;
 
@@ -113,7 +113,7 @@ namespace Antioch
 
 
   template <typename CoeffType>
-  template<typename StateType, typename VectorStateType>
+  template<typename StateType, typename VectorStateType, typename KineticsClass>
   inline
   StateType ThreeBodyReaction<CoeffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                                             const KineticsConditions<StateType,VectorStateType>& conditions  ) const
@@ -127,7 +127,7 @@ namespace Antioch
       }
 
     //... alpha(T)
-    kfwd *= (*this->_forward_rate[0])(conditions);
+    kfwd *= static_cast<const KineticsClass&>(*this->_forward_rate[0])(conditions);
 
     antioch_assert(!has_nan(kfwd));
 
@@ -143,6 +143,56 @@ namespace Antioch
                            StateType &dF_dT,
                            VectorStateType &dF_dX) const;
 
+    //! F and its derivatives with respect to T and [M]
+    /*! \f$F\f$ depends on the concentrations only through \f$[M]\f$,
+     *  so \f$\frac{\partial F}{\partial c_i} = \frac{\partial F}{\partial [M]}\f$
+     *  up to the third-body efficiency of species \f$i\f$. This avoids
+     *  a species-sized work vector.
+     */
+    template <typename StateType>
+    void F_and_M_derivative(const StateType& T,
+                            const StateType &M,
+                            const StateType &k0,
+                            const StateType &dk0_dT,
+                            const StateType &kinf,
+                            const StateType &dkinf_dT,
+                            StateType &F,
+                            StateType &dF_dT,
+                            StateType &dF_dM) const;
+
+    //! \f$F_{\text{cent}}\f$, only depends on the temperature
+    template <typename StateType>
+    StateType Fcent(const StateType &T) const;
+
+    //! \f$F_{\text{cent}}\f$ and its temperature derivative
+    template <typename StateType>
+    void Fcent_and_derivatives( const StateType &T,
+                                StateType &Fc,
+                                StateType &dFc_dT ) const;
+
+    //! Same as operator(), with a precomputed \f$F_{\text{cent}}\f$
+    template <typename StateType>
+    StateType F_from_Fcent(const StateType &T,
+                           const StateType &Fcent,
+                           const StateType &M,
+                           const StateType &k0,
+                           const StateType &kinf) const;
+
+    //! Same as F_and_M_derivative(), with a precomputed \f$F_{\text{cent}}\f$
+    /*! The derivatives of F_and_derivatives() and F_and_M_derivative() are computed here. */
+    template <typename StateType>
+    void F_and_M_derivative_from_Fcent(const StateType& T,
+                                       const StateType &Fcent,
+                                       const StateType &dFcent_dT,
+                                       const StateType &M,
+                                       const StateType &k0,
+                                       const StateType &dk0_dT,
+                                       const StateType &kinf,
+                                       const StateType &dkinf_dT,
+                                       StateType &F,
+                                       StateType &dF_dT,
+                                       StateType &dF_dM) const;
+
   private:
 
     unsigned int n_spec;
@@ -159,14 +209,6 @@ namespace Antioch
     /*! This is needed because Eigen doesn't understand log10. */
     CoeffType _n_coeff;
 
-    template <typename StateType>
-    StateType Fcent(const StateType &T) const;
-
-    template <typename StateType>
-    void Fcent_and_derivatives( const StateType &T,
-                                StateType &Fc,
-                                StateType &dFc_dT ) const;
-
   };
 
   template<typename CoeffType>
@@ -238,7 +280,18 @@ namespace Antioch
                                                const StateType &k0, 
                                                const StateType &kinf) const
   {
-    StateType F_cent = this->Fcent(T);  // = 0
+    return this->F_from_Fcent(T, this->Fcent(T), M, k0, kinf);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  StateType TroeFalloff<CoeffType>::F_from_Fcent(const StateType& T,
+                                                 const StateType &F_cent,
+                                                 const StateType &M,
+                                                 const StateType &k0,
+                                                 const StateType &kinf) const
+  {
     antioch_assert(!has_nan(F_cent));
 
     //compute log(F_cent) once.
@@ -331,21 +384,58 @@ namespace Antioch
 
     antioch_assert_equal_to(dF_dX.size(),this->n_spec);
 
-    //declarations
+    // F depends on the concentrations only through [M]
+    StateType dF_dM = Antioch::zero_clone(T);
+    this->F_and_M_derivative(T,M,k0,dk0_dT,kinf,dkinf_dT,F,dF_dT,dF_dM);
+
+    for(unsigned int ip = 0; ip < dF_dX.size(); ip++)
+      dF_dX[ip] = dF_dM;
+
+    return;
+  }
+
+  template <typename CoeffType>
+  template <typename StateType>
+  inline
+  void TroeFalloff<CoeffType>::F_and_M_derivative(const StateType& T,
+                                                  const StateType &M,
+                                                  const StateType &k0,
+                                                  const StateType &dk0_dT,
+                                                  const StateType &kinf,
+                                                  const StateType &dkinf_dT,
+                                                  StateType &F,
+                                                  StateType &dF_dT,
+                                                  StateType &dF_dM) const
+  {
+    StateType Fcent = Antioch::zero_clone(T);
+    StateType dFcent_dT = Antioch::zero_clone(T);
+    this->Fcent_and_derivatives(T,Fcent,dFcent_dT);
+
+    this->F_and_M_derivative_from_Fcent(T,Fcent,dFcent_dT,M,k0,dk0_dT,kinf,dkinf_dT,F,dF_dT,dF_dM);
+  }
+
+  template <typename CoeffType>
+  template <typename StateType>
+  inline
+  void TroeFalloff<CoeffType>::F_and_M_derivative_from_Fcent(const StateType& T,
+                                                             const StateType &Fcent,
+                                                             const StateType &dFcent_dT,
+                                                             const StateType &M,
+                                                             const StateType &k0,
+                                                             const StateType &dk0_dT,
+                                                             const StateType &kinf,
+                                                             const StateType &dkinf_dT,
+                                                             StateType &F,
+                                                             StateType &dF_dT,
+                                                             StateType &dF_dM) const
+  {
     // Pr and derivatives
     StateType Pr = M * k0/kinf;
     StateType dPr_dT = Pr * (dk0_dT/k0 - dkinf_dT/kinf);
     StateType log10Pr = Constants::log10_to_log<CoeffType>() * ant_log(Pr);
     StateType dlog10Pr_dT = Constants::log10_to_log<CoeffType>()*dPr_dT/Pr;
-    VectorStateType dlog10Pr_dX = Antioch::zero_clone(dF_dX);
-    for(unsigned int ip = 0; ip < dlog10Pr_dX.size(); ip++)
-      {//dlog10Pr_dX = 1/(ln(10)*Pr) * dPr_dX
-        dlog10Pr_dX[ip] = Constants::log10_to_log<CoeffType>()/M; //dPr_dX = k0/kinf, Pr = M k0/kinf => dlog10Pr_dX = 1/(ln(10)*M)
-      }
-    // Fcent and derivatives
-    StateType Fcent = Antioch::zero_clone(T);
-    StateType dFcent_dT = Antioch::zero_clone(T);
-    this->Fcent_and_derivatives(T,Fcent,dFcent_dT);
+    StateType dlog10Pr_dM = Constants::log10_to_log<CoeffType>()/M;
+
     antioch_assert(!has_nan(Fcent));
 
     StateType dlog10Fcent_dT = Constants::log10_to_log<CoeffType>()*dFcent_dT/Fcent;
@@ -360,18 +450,15 @@ namespace Antioch
 
     //log10F
     StateType logF = logFcent/(1 + ant_pow(((log10Pr + c)/(n - d*(log10Pr + c) )),2));
-    StateType dlogF_dT = logF * (dlog10Fcent_dT / Fcent 
+    StateType dlogF_dT = logF * (dlog10Fcent_dT / Fcent
                                      - 2 * ant_pow((log10Pr + c)/(n - d * (log10Pr + c)),2)
                                        * ((dlog10Pr_dT + dc_dT)/(log10Pr + c) -
                                           (dn_dT - d * (dlog10Pr_dT + dc_dT))/(n - d * (log10Pr + c))
                                          )
                                        / (1 + ant_pow((log10Pr + c)/(n - d * (log10Pr + c)),2))
                                     );
-    VectorStateType dlogF_dX = Antioch::zero_clone(dF_dX);
-    for(unsigned int ip = 0; ip < dlog10Pr_dX.size(); ip++)
-      {//dlogF_dX = - logF^2/log(Fcent) * dlog10Pr_dX * (1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c)
-        dlogF_dX[ip] = - ant_pow(logF,2)/logFcent * dlog10Pr_dX[ip] *(1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c);
-      }
+    //dlogF_dM = - logF^2/log(Fcent) * dlog10Pr_dM * (1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c)
+    StateType dlogF_dM = - ant_pow(logF,2)/logFcent * dlog10Pr_dM *(1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c);
 
     F = ant_exp(logF);
     typename Antioch::rebind<StateType, bool>::type Fcent_is_nonzero = (Fcent != Antioch::zero_clone(T));
@@ -379,10 +466,7 @@ namespace Antioch
     antioch_assert(!has_nan(F));
 
     dF_dT = F * dlogF_dT;
-    for(unsigned int ip = 0; ip < dlog10Pr_dX.size(); ip++)
-      {//dF_dX =  F * dlogF_dX
-        dF_dX[ip] = F * dlogF_dX[ip];
-      }
+    dF_dM = F * dlogF_dM;
 
     return;
   }
@@ -27,12 +27,22 @@
 #ifndef ANTIOCH_PARTICLE_FLUX_H
 #define ANTIOCH_PARTICLE_FLUX_H
 
+// Antioch
+#include "antioch/metaprogramming.h"
+#include "antioch/antioch_asserts.h"
+
+// C++
+#include <atomic>
+
 namespace Antioch
 {
 
   /*!\class ParticleFlux
    * Stores the incoming flux of particles
    *
+   * The abscissa must be sorted in increasing order, it is checked
+   * whenever it is set, so that its users (e.g. SigmaBinConverter)
+   * need not check it again.
    */
   template<typename VectorCoeffType>
   class ParticleFlux
@@ -44,6 +54,14 @@ namespace Antioch
         bool _x_updated;
         unsigned int _n_coupled;
         unsigned int _n_updated;
+        unsigned long _abscissa_version;
+
+        //! A value never returned before, by any flux
+        static unsigned long new_abscissa_version();
+
+        //! Errors out if \p x is not sorted in increasing order
+        template<typename VectorStateType>
+        static void check_abscissa(const VectorStateType &x);
 
      public:
         ParticleFlux();
@@ -56,6 +74,13 @@ namespace Antioch
         //!
         bool x_updated() const;
 
+        //! Identifies the abscissa
+        /*! Changes each time the abscissa is set, and differs between
+         *  fluxes: quantities computed on the abscissa can be cached
+         *  with this value as a key.
+         */
+        unsigned long abscissa_version() const;
+
         //!
         const VectorCoeffType &abscissa() const;
 
@@ -126,6 +151,21 @@ namespace Antioch
      return _x_updated;
   }
 
+  template<typename VectorCoeffType>
+  inline
+  unsigned long ParticleFlux<VectorCoeffType>::abscissa_version() const
+  {
+     return _abscissa_version;
+  }
+
+  template<typename VectorCoeffType>
+  inline
+  unsigned long ParticleFlux<VectorCoeffType>::new_abscissa_version()
+  {
+     static std::atomic<unsigned long> last_version(0);
+     return ++last_version;
+  }
+
   template<typename VectorCoeffType>
   inline
   void ParticleFlux<VectorCoeffType>::update_done()
@@ -145,9 +185,23 @@ namespace Antioch
   inline
   void ParticleFlux<VectorCoeffType>::set_abscissa(const VectorStateType &x)
   {
+     check_abscissa(x);
      _abscissa = x;
      _updated = true;
      _x_updated = true;
+     _abscissa_version = new_abscissa_version();
+  }
+
+  template<typename VectorCoeffType>
+  template<typename VectorStateType>
+  inline
+  void ParticleFlux<VectorCoeffType>::check_abscissa(const VectorStateType &x)
+  {
+     for(unsigned int i = 1; i < x.size(); i++)
+     {
+        if(Antioch::disjunction(x[i] < x[i-1]))
+          antioch_error_msg("The abscissa of a particle flux must be sorted in increasing order, value " << i << " is not.");
+     }
   }
 
   template<typename VectorCoeffType>
@@ -165,7 +219,8 @@ namespace Antioch
   _updated(false),
   _x_updated(false),
   _n_coupled(0),
-  _n_updated(0)
+  _n_updated(0),
+  _abscissa_version(new_abscissa_version())
   {
     return;
   }
@@ -185,8 +240,10 @@ namespace Antioch
   _updated(true),
   _x_updated(true),
   _n_coupled(0),
-  _n_updated(0)
+  _n_updated(0),
+  _abscissa_version(new_abscissa_version())
   {
+    check_abscissa(x);
     return;
   }
 
@@ -38,6 +38,64 @@
 
 namespace Antioch{
 
+namespace AntiochPrivate
+{
+  //! Head indices policy, scalar custom grid
+  /*! ihead[ic] is the first index i < x_old.size() - 1 such that
+   *  x_custom[ic] < x_old[i], x_old.size() - 1 if there is none.
+   *  Both grids are sorted, so the heads are found by merging them.
+   *  The custom grid is not checked here, its sortedness is checked
+   *  once, where it is set (e.g. ParticleFlux::set_abscissa()). */
+  template <bool B /*masked*/>
+  struct SigmaBinHeadsPolicy
+  {
+    template <typename VectorCoeffType, typename VectorStateType, typename UIntType, typename VUIntType>
+    void find_heads(const VectorCoeffType & x_old, const VectorStateType & x_custom,
+                    const UIntType & /*example*/, VUIntType & ihead)
+    {
+      unsigned int i = 0;
+      for(unsigned int ic = 0; ic < x_custom.size(); ic++)
+      {
+        while(i < x_old.size() - 1 && !(x_custom[ic] < x_old[i]))
+          ++i;
+
+        ihead[ic] = i;
+      }
+    }
+  };
+
+  //! Head indices policy, vectorized custom grid
+  /*! Lanes do not share their heads, every one of them
+   *  is searched through the whole reference grid. */
+  template <>
+  struct SigmaBinHeadsPolicy<true /*masked*/>
+  {
+    template <typename VectorCoeffType, typename VectorStateType, typename UIntType, typename VUIntType>
+    void find_heads(const VectorCoeffType & x_old, const VectorStateType & x_custom,
+                    const UIntType & example, VUIntType & ihead)
+    {
+      UIntType unfound = Antioch::constant_clone(example,x_old.size()-1);
+
+      for(unsigned int ic = 0; ic < x_custom.size(); ic++)
+      {
+        UIntType ihigh = Antioch::constant_clone(example,x_old.size()-1);
+        for (unsigned int i = 0; i != x_old.size() - 1; ++i)
+        {
+          UIntType icus  = Antioch::constant_clone(example,ic);
+
+          ihigh = Antioch::if_else (Antioch::eval_index(x_custom,icus) < x_old[i] && ihigh == unfound,
+                                    Antioch::constant_clone(example,i),
+                                    ihigh);
+
+          if(Antioch::conjunction(ihigh != unfound))break; // once we found everyone, don't waste time
+        }
+        ihead[ic] = ihigh;
+      }
+    }
+  };
+
+} // end namespace AntiochPrivate
+
 template <typename VectorCoeffType = std::vector<double> >
 class SigmaBinConverter
 {
@@ -45,12 +103,29 @@ class SigmaBinConverter
         SigmaBinConverter();
         ~SigmaBinConverter();
 
+        //! Bin y_old, given on the x_old grid, onto the x_new grid (right stairs)
+        /*! Both grids must be sorted in increasing order. Scalar states
+         *  are binned with a sorted merge of the two grids, in O(N+M);
+         *  vectorized states (VexCL, Eigen, ...) use the lane-masked
+         *  search of y_on_custom_grid_masked(). */
         template <typename VectorStateType>
         void y_on_custom_grid(const VectorCoeffType &x_old, const VectorCoeffType &y_old, 
                               const VectorStateType &x_new,       VectorStateType &y_new) const;
 
+        //! Bin with the lane-masked search, whatever the state type
+        /*! Every lane of x_new is searched independently through x_old,
+         *  in O(N*M). This is the algorithm vectorized state types need,
+         *  it is kept public to compare against the merge. */
+        template <typename VectorStateType>
+        void y_on_custom_grid_masked(const VectorCoeffType &x_old, const VectorCoeffType &y_old, 
+                                     const VectorStateType &x_new,       VectorStateType &y_new) const;
+
      private:
 
+        template <bool masked, typename VectorStateType>
+        void bin_on_custom_grid(const VectorCoeffType &x_old, const VectorCoeffType &y_old, 
+                                const VectorStateType &x_new,       VectorStateType &y_new) const;
+
         template <typename StateType, typename VUIntType>
         StateType custom_bin_value(const StateType & custom_head, const StateType & custom_tail,
                                    const VUIntType & index_heads, unsigned int custom_head_index,
@@ -78,6 +153,25 @@ template <typename VectorStateType>
 inline
 void SigmaBinConverter<VectorCoeffType>::y_on_custom_grid(const VectorCoeffType &x_old, const VectorCoeffType &y_old,  
                                                           const VectorStateType &x_custom,    VectorStateType &y_custom) const
+{
+  this->template bin_on_custom_grid<Antioch::has_size<typename Antioch::value_type<VectorStateType>::type>::value>
+                                                         (x_old,y_old,x_custom,y_custom);
+}
+
+template <typename VectorCoeffType>
+template <typename VectorStateType>
+inline
+void SigmaBinConverter<VectorCoeffType>::y_on_custom_grid_masked(const VectorCoeffType &x_old, const VectorCoeffType &y_old,  
+                                                                 const VectorStateType &x_custom,    VectorStateType &y_custom) const
+{
+  this->template bin_on_custom_grid<true>(x_old,y_old,x_custom,y_custom);
+}
+
+template <typename VectorCoeffType>
+template <bool masked, typename VectorStateType>
+inline
+void SigmaBinConverter<VectorCoeffType>::bin_on_custom_grid(const VectorCoeffType &x_old, const VectorCoeffType &y_old,  
+                                                            const VectorStateType &x_custom,    VectorStateType &y_custom) const
 {
 // data consistency
   antioch_assert_not_equal_to(x_custom.size(),0);
@@ -103,23 +197,7 @@ void SigmaBinConverter<VectorCoeffType>::y_on_custom_grid(const VectorCoeffType
   VUIntType ihead(x_custom.size()); 
   Antioch::init_constant(ihead,example);
 
-  UIntType unfound = Antioch::constant_clone(example,x_old.size()-1);
-
-  for(unsigned int ic = 0; ic < x_custom.size(); ic++)
-  {
-    UIntType ihigh = Antioch::constant_clone(example,x_old.size()-1);
-    for (unsigned int i = 0; i != x_old.size() - 1; ++i)
-    {
-      UIntType icus  = Antioch::constant_clone(example,ic);
-
-      ihigh = Antioch::if_else (Antioch::eval_index(x_custom,icus) < x_old[i] && ihigh == unfound,
-                                Antioch::constant_clone(example,i),
-                                ihigh);
-
-      if(Antioch::conjunction(ihigh != unfound))break; // once we found everyone, don't waste time
-    }
-    ihead[ic] = ihigh;
-  }
+  AntiochPrivate::SigmaBinHeadsPolicy<masked>().find_heads(x_old,x_custom,example,ihead);
 
   // bin
   for(unsigned int ic = 0; ic < x_custom.size() - 1; ic++) // right stairs, last one = 0
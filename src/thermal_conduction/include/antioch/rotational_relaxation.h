@@ -31,6 +31,7 @@
 #include "antioch/metaprogramming_decl.h"
 #include "antioch/math_constants.h"
 #include "antioch/cmath_shims.h"
+#include "antioch/extended_temp_cache.h"
 
 // C++
 
@@ -45,12 +46,17 @@ namespace Antioch
 
         void reset_coeffs( CoeffType rot, CoeffType depth);
 
-        // \todo
-        // cache _eps_kb / 298
         template <typename StateType>
         ANTIOCH_AUTO(StateType)
           operator()(const StateType & T) const
-        ANTIOCH_AUTOFUNC(StateType, _z_298 * this->F(_eps_kb / 298) / this->F(StateType(_eps_kb/T)))
+        ANTIOCH_AUTOFUNC(StateType, _z_298_over_F_298 / this->F(StateType(_eps_kb/T), StateType(ant_sqrt(_eps_kb/T))))
+
+        //! Same as above, sqrt(eps/T) from the cached sqrt(T) and 1/T
+        template <typename StateType>
+        ANTIOCH_AUTO(StateType)
+          operator()(const ExtendedTempCache<StateType> & cache) const
+        ANTIOCH_AUTOFUNC(StateType, _z_298_over_F_298 / this->F(StateType(_eps_kb * cache.inv_T()),
+                                                                StateType(_sqrt_eps_kb * cache.sqrt_T() * cache.inv_T())))
 
         //!
         CoeffType Z_298() const
@@ -64,13 +70,19 @@ namespace Antioch
 
         RotationalRelaxation();
 
+        //! F(eps/T), given eps/T and its square root
         template <typename StateType>
         ANTIOCH_AUTO(StateType)
-          F(const StateType & eps_T) const
-        ANTIOCH_AUTOFUNC(StateType, _one + _pi32_2 * ant_sqrt(eps_T) + _pi2_4_plus_2 * eps_T + _pi32 * ant_pow(eps_T,CoeffType(1.5))) //unambiguate pow() for vexcl
+          F(const StateType & eps_T, const StateType & sqrt_eps_T) const
+        ANTIOCH_AUTOFUNC(StateType, _one + _pi32_2 * sqrt_eps_T + _pi2_4_plus_2 * eps_T + _pi32 * eps_T * sqrt_eps_T)
+
+        //! Computes the coefficients depending on eps/kb
+        void compute_eps_terms();
 
         CoeffType _z_298;
         CoeffType _eps_kb;
+        CoeffType _sqrt_eps_kb;
+        CoeffType _z_298_over_F_298;
         const CoeffType _one;
         const CoeffType _pi32_2;
         const CoeffType _pi2_4_plus_2;
@@ -86,6 +98,7 @@ namespace Antioch
                 _pi2_4_plus_2(Constants::pi<CoeffType>() * Constants::pi<CoeffType>() / 4 + 2),
                 _pi32(ant_pow(Constants::pi<CoeffType>(),CoeffType(1.5)))
   {
+     this->compute_eps_terms();
      return;
   }
 
@@ -95,6 +108,17 @@ namespace Antioch
   {
      _z_298 = rot;
      _eps_kb = depth;
+     this->compute_eps_terms();
+  }
+
+  template <typename CoeffType>
+  inline
+  void RotationalRelaxation<CoeffType>::compute_eps_terms()
+  {
+     _sqrt_eps_kb = ant_sqrt(_eps_kb);
+
+     const CoeffType eps_298 = _eps_kb / 298;
+     _z_298_over_F_298 = _z_298 * this->F(eps_298, CoeffType(ant_sqrt(eps_298)));
   }
 
 }
@@ -74,6 +74,7 @@ namespace Antioch
 
     this->check_coeff_size();
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -93,6 +94,7 @@ namespace Antioch
 
     this->check_coeff_size();
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+#ifndef ANTIOCH_EXTENDED_TEMP_CACHE_H
+#define ANTIOCH_EXTENDED_TEMP_CACHE_H
+
+// Antioch
+#include "antioch/temp_cache.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming_decl.h"
+
+namespace Antioch
+{
+  //! TempCache with the inverse and fractional powers of T
+  /*!
+   * Opt-in: only the evaluators reading these values (Sutherland
+   * viscosity, rotational relaxation) take an ExtendedTempCache, so
+   * TempCache users do not pay for the division and the square root.
+   * As for TempCache, all the values are computed up front.
+   */
+  template<typename StateType=double>
+  class ExtendedTempCache : public TempCache<StateType>
+  {
+  public:
+
+    explicit ExtendedTempCache(const StateType& T_in);
+
+    ExtendedTempCache(const StateType& T_in,
+                      const StateType& T2_in,
+                      const StateType& T3_in,
+                      const StateType& T4_in,
+                      const StateType& lnT_in);
+
+    //! Copies the values cached by \p other, see TempCache::operator=()
+    ExtendedTempCache& operator=(const ExtendedTempCache& other);
+
+    //! Recomputes all the cached values, see TempCache::update()
+    void update();
+
+    //! 1/T
+    const StateType& inv_T() const;
+
+    //! 1/T^2
+    const StateType& inv_T2() const;
+
+    //! sqrt(T)
+    const StateType& sqrt_T() const;
+
+    //! T^1.5
+    const StateType& T_1p5() const;
+
+  private:
+
+    ExtendedTempCache();
+
+    //! Computes the inverse and fractional powers of T
+    void compute_powers();
+
+    StateType _inv_T;
+    StateType _inv_T2;
+    StateType _sqrt_T;
+    StateType _T_1p5;
+
+  };
+
+  template<typename StateType>
+  inline
+  ExtendedTempCache<StateType>::ExtendedTempCache(const StateType& T_in)
+    : TempCache<StateType>(T_in),
+      _inv_T(T_in), _inv_T2(T_in), _sqrt_T(T_in), _T_1p5(T_in)
+  {
+    this->compute_powers();
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  ExtendedTempCache<StateType>::ExtendedTempCache(const StateType& T_in,
+                                                  const StateType& T2_in,
+                                                  const StateType& T3_in,
+                                                  const StateType& T4_in,
+                                                  const StateType& lnT_in)
+    : TempCache<StateType>(T_in,T2_in,T3_in,T4_in,lnT_in),
+      _inv_T(T_in), _inv_T2(T_in), _sqrt_T(T_in), _T_1p5(T_in)
+  {
+    this->compute_powers();
+    return;
+  }
+
+  template<typename StateType>
+  inline
+  ExtendedTempCache<StateType> & ExtendedTempCache<StateType>::operator=(const ExtendedTempCache<StateType>& other)
+  {
+    if( this == &other )
+      return *this;
+
+    TempCache<StateType>::operator=(other);
+    _inv_T  = other._inv_T;
+    _inv_T2 = other._inv_T2;
+    _sqrt_T = other._sqrt_T;
+    _T_1p5  = other._T_1p5;
+
+    return *this;
+  }
+
+  template<typename StateType>
+  inline
+  void ExtendedTempCache<StateType>::update()
+  {
+    TempCache<StateType>::update();
+    this->compute_powers();
+  }
+
+  template<typename StateType>
+  inline
+  void ExtendedTempCache<StateType>::compute_powers()
+  {
+    typedef typename Antioch::value_type<StateType>::type ScalarType;
+
+    _inv_T  = ScalarType(1)/this->T;
+    _inv_T2 = _inv_T*_inv_T;
+    _sqrt_T = ant_sqrt(this->T);
+    _T_1p5  = this->T*_sqrt_T;
+  }
+
+  template<typename StateType>
+  inline
+  const StateType& ExtendedTempCache<StateType>::inv_T() const
+  {
+    return _inv_T;
+  }
+
+  template<typename StateType>
+  inline
+  const StateType& ExtendedTempCache<StateType>::inv_T2() const
+  {
+    return _inv_T2;
+  }
+
+  template<typename StateType>
+  inline
+  const StateType& ExtendedTempCache<StateType>::sqrt_T() const
+  {
+    return _sqrt_T;
+  }
+
+  template<typename StateType>
+  inline
+  const StateType& ExtendedTempCache<StateType>::T_1p5() const
+  {
+    return _T_1p5;
+  }
+
+}
+
+#endif // ANTIOCH_EXTENDED_TEMP_CACHE_H
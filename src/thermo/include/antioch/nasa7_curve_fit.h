@@ -125,6 +125,7 @@ namespace Antioch
 
     this->check_coeff_size();
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -141,6 +142,7 @@ namespace Antioch
 
     this->check_coeff_size();
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -153,6 +155,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -161,8 +164,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-	returnval = Antioch::if_else
-	  (interval == i,
+	this->select_interval
+	  (interval, i, single_interval,
 	   StateType(a[0] + a[1]*cache.T + a[2]*cache.T2 + a[3]*cache.T3 + a[4]*cache.T4),
 	   returnval);
       }
@@ -181,6 +184,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -189,8 +193,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-        returnval = Antioch::if_else
-          (interval == i,
+        this->select_interval
+          (interval, i, single_interval,
            StateType(a[1] + 2*a[2]*cache.T + 3*a[3]*cache.T2 + 4*a[4]*cache.T3),
            returnval);
       }
@@ -208,6 +212,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -216,8 +221,8 @@ namespace Antioch
          const CoeffType *a = this->coefficients(i);
 
          /* h/RT = a0     + a1*T/2 + a2*T^2/3 + a3*T^3/4 + a4*T^4/5 + a5/T */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
            StateType(  a[0] +
                        a[1]*cache.T/2 +
                        a[2]*cache.T2/3 +
@@ -239,6 +244,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -247,8 +253,8 @@ namespace Antioch
          const CoeffType *a = this->coefficients(i);
 
     /* s/R = a0*lnT + a1*T   + a2*T^2/2 + a3*T^3/3 + a4*T^4/4 + a6 */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
            StateType(   a[0]*cache.lnT +
                         a[1]*cache.T +
                         a[2]*cache.T2/2 +
@@ -271,6 +277,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -280,8 +287,8 @@ namespace Antioch
 
     /* h/RT =  a[0]     + a[1]*T/2. + a[2]*T2/3. + a[3]*T3/4. + a[4]*T4/5. + a[5]/T,
        s/R  =  a[0]*lnT + a[1]*T    + a[2]*T2/2. + a[3]*T3/3. + a[4]*T4/4. + a[6]   */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
 	   StateType(a[5]/cache.T - a[0]*cache.lnT
                      + a[0] - a[6]
 		     - a[1]/2*cache.T
@@ -303,6 +310,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -314,8 +322,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-	returnval = Antioch::if_else
-	  (interval == i,
+	this->select_interval
+	  (interval, i, single_interval,
 	   StateType(- a[5]/cache.T2     - a[0]/cache.T
 		     - a[1]/2          - a[2]*cache.T/3
                      - a[3]*cache.T2/4 - a[4]*cache.T3/5 ),
@@ -173,6 +173,7 @@ namespace Antioch
 
     this->check_coeff_size();
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -186,6 +187,7 @@ namespace Antioch
     this->init_nasa9_temps( coeffs, this->_n_coeffs );
 
     this->check_temp_coeff_size_consistency();
+    this->init_interval_lookup();
   }
 
   template<typename CoeffType>
@@ -214,6 +216,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -223,8 +226,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-        returnval = Antioch::if_else
-          (interval == i,
+        this->select_interval
+          (interval, i, single_interval,
            StateType(a[0]/cache.T2 + a[1]/cache.T + a[2] + a[3]*cache.T +
                      a[4]*cache.T2 + a[5]*cache.T3 + a[6]*cache.T4),
            returnval);
@@ -244,6 +247,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -253,8 +257,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-        returnval = Antioch::if_else
-          (interval == i,
+        this->select_interval
+          (interval, i, single_interval,
            StateType(-2*a[0]/cache.T3 - a[1]/cache.T2 + a[3] +
                      2*a[4]*cache.T + 3*a[5]*cache.T2 + 4*a[6]*cache.T3),
            returnval);
@@ -274,6 +278,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -282,8 +287,8 @@ namespace Antioch
          const CoeffType *a = this->coefficients(i);
 
          /* h/RT = -a0*T^-2   + a1*T^-1*lnT + a2     + a3*T/2 + a4*T^2/3 + a5*T^3/4 + a6*T^4/5 + a7/T */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
            StateType( -a[0]/cache.T2 +
                       a[1]*cache.lnT/cache.T +
                       a[2] +
@@ -307,6 +312,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -315,8 +321,8 @@ namespace Antioch
          const CoeffType *a = this->coefficients(i);
 
     /* s/R = -a0*T^-2/2 - a1*T^-1     + a2*lnT + a3*T   + a4*T^2/2 + a5*T^3/3 + a6*T^4/4 + a8 */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
           StateType( -a[0]/cache.T2/2 -
                      a[1]/cache.T +
                      a[2]*cache.lnT +
@@ -341,6 +347,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     StateType returnval = Antioch::zero_clone(cache.T);
 
@@ -350,8 +357,8 @@ namespace Antioch
 
     /* h/RT = -a[0]/T2    + a[1]*lnT/T + a[2]     + a[3]*T/2. + a[4]*T2/3. + a[5]*T3/4. + a[6]*T4/5. + a[7]/T,
        s/R  = -a[0]/T2/2. - a[1]/T     + a[2]*lnT + a[3]*T    + a[4]*T2/2. + a[5]*T3/3. + a[6]*T4/4. + a[8]   */
-        returnval = Antioch::if_else
-        ( interval == i,
+        this->select_interval
+        (interval, i, single_interval,
           StateType(-a[0]/cache.T2/2
                     + (a[1] + a[7])/cache.T
                     + a[1]*cache.lnT/cache.T
@@ -376,6 +383,7 @@ namespace Antioch
     const UIntType interval = this->interval(cache.T);
     const unsigned int begin_interval = Antioch::min(interval);
     const unsigned int end_interval = Antioch::max(interval)+1;
+    const bool single_interval = (begin_interval + 1 == end_interval);
 
     // FIXME - this needs expression templates to be faster...
 
@@ -387,8 +395,8 @@ namespace Antioch
       {
         const CoeffType * const a =
           this->coefficients(i);
-        returnval = Antioch::if_else
-          (interval == i,
+        this->select_interval
+          (interval, i, single_interval,
            StateType(a[0]/cache.T3 - a[7]/cache.T2 -
                      a[1]*cache.lnT/cache.T2 - a[2]/cache.T -
                      a[3]/2  - a[4]*cache.T/3 - a[5]*cache.T2/4 -
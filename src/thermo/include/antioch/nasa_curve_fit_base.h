@@ -33,6 +33,8 @@
 #include "antioch/metaprogramming.h"
 
 // C++
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <sstream>
 
@@ -53,7 +55,12 @@ namespace Antioch
     //! The interval the input temperature lies in
     /*!
       @returns which curve fit interval the input temperature
-      lies in.
+      lies in. Temperatures on a breakpoint or outside of the fit
+      range are in the first interval.
+
+      Batches whose lowest and highest temperatures are strictly
+      inside the same interval, and scalars, are placed with the
+      precomputed lookup, with no loop over the breakpoints.
      */
     template <typename StateType>
     typename Antioch::rebind<StateType, unsigned int>::type
@@ -65,6 +72,9 @@ namespace Antioch
     */
     const CoeffType* coefficients(const unsigned int interval) const;
 
+    //! @returns the temperatures bounding the intervals
+    const std::vector<CoeffType>& temperatures() const;
+
     //! @changes the value of the coefficient specified in the
     //  interval specified.
     void set_coefficient(unsigned int interval,
@@ -79,6 +89,27 @@ namespace Antioch
 
     void check_temp_coeff_size_consistency() const;
 
+    //! Builds the breakpoint lookup, once _temp is set
+    void init_interval_lookup();
+
+    //! The interval of a scalar temperature, from the lookup
+    /*!
+      \p valid is false for temperatures on a breakpoint or outside
+      of the fit range, whose interval is 0.
+     */
+    template <typename ScalarType>
+    unsigned int lookup_interval(const ScalarType& T, bool& valid) const;
+
+    //! Blends \p value into \p result for the lanes in interval \p i
+    /*!
+      A plain copy when \p single_interval, i.e. all the lanes are in
+      interval \p i.
+     */
+    template <typename StateType, typename UIntType>
+    void select_interval(const UIntType& interval, unsigned int i,
+                         bool single_interval, const StateType& value,
+                         StateType& result) const;
+
     //! The number of coefficients in each interval
     unsigned int _n_coeffs;
 
@@ -96,6 +127,23 @@ namespace Antioch
      */
     std::vector<CoeffType> _temp;
 
+    //! Uniform cells over the fit range, for lookup_interval()
+    /*!
+      The cells are narrower than the intervals, each one holds at
+      most one breakpoint. Empty when the breakpoints are too close
+      for a reasonably sized lookup, interval() then loops.
+     */
+    std::vector<CoeffType> _lookup_start;
+
+    //! Inverse of the width of the lookup cells
+    CoeffType _lookup_inv_width;
+
+    //! Interval of the beginning of each lookup cell
+    std::vector<unsigned int> _lookup_interval;
+
+    //! Breakpoint in each lookup cell, end of the cell if none
+    std::vector<CoeffType> _lookup_break;
+
   };
 
   template<typename CoeffType>
@@ -104,7 +152,8 @@ namespace Antioch
                                                  const std::vector<CoeffType>& temp )
     : _n_coeffs(0),
       _coefficients(coeffs),
-      _temp(temp)
+      _temp(temp),
+      _lookup_inv_width(0)
   {}
 
   template<typename CoeffType>
@@ -123,6 +172,27 @@ namespace Antioch
     UIntType interval;
     Antioch::zero_clone(interval, T);
 
+    // All the lanes in the same interval: the intervals are convex,
+    // the extreme temperatures are enough
+    if( !_lookup_start.empty() )
+      {
+        const typename Antioch::value_type<StateType>::type T_min = Antioch::min(T);
+        const typename Antioch::value_type<StateType>::type T_max = Antioch::max(T);
+
+        bool valid_min;
+        const unsigned int i_min = this->lookup_interval(T_min, valid_min);
+
+        // uniform temperature, scalars in particular
+        if( T_max == T_min )
+          return valid_min ? Antioch::constant_clone(interval, i_min) : interval;
+
+        bool valid_max;
+        const unsigned int i_max = this->lookup_interval(T_max, valid_max);
+
+        if( valid_min && valid_max && i_min == i_max )
+          return Antioch::constant_clone(interval, i_min);
+      }
+
     for(unsigned int i = 1; i < _temp.size(); ++i)
     {
         interval = Antioch::if_else
@@ -134,6 +204,49 @@ namespace Antioch
     return interval;
   }
 
+  template<typename CoeffType>
+  template<typename ScalarType>
+  inline
+  unsigned int NASACurveFitBase<CoeffType>::lookup_interval(const ScalarType& T, bool& valid) const
+  {
+    valid = ( T > _temp.front() && T < _temp.back() );
+    if( !valid )
+      return 0;
+
+    const unsigned int n_cells = _lookup_interval.size();
+
+    // the rounding of the cell index is corrected by the exact
+    // bounds of the cells
+    unsigned int c = static_cast<unsigned int>( (T - _temp.front()) * _lookup_inv_width );
+    c = std::min( c, n_cells - 1 );
+    c -= ( c > 0 && T < _lookup_start[c] );
+    c += ( T >= _lookup_start[c+1] );
+
+    valid = ( T != _lookup_break[c] );
+
+    return valid * ( _lookup_interval[c] + ( T > _lookup_break[c] ) );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename UIntType>
+  inline
+  void NASACurveFitBase<CoeffType>::select_interval(const UIntType& interval, unsigned int i,
+                                                    bool single_interval, const StateType& value,
+                                                    StateType& result) const
+  {
+    if( single_interval )
+      result = value;
+    else
+      result = Antioch::if_else(interval == i, value, result);
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& NASACurveFitBase<CoeffType>::temperatures() const
+  {
+    return _temp;
+  }
+
   template<typename CoeffType>
   inline
   const CoeffType* NASACurveFitBase<CoeffType>::coefficients(const unsigned int interval) const
@@ -197,6 +310,61 @@ namespace Antioch
       }
   }
 
+  template<typename CoeffType>
+  inline
+  void NASACurveFitBase<CoeffType>::init_interval_lookup()
+  {
+    _lookup_start.clear();
+    _lookup_interval.clear();
+    _lookup_break.clear();
+
+    const unsigned int n_temps = _temp.size();
+    if( n_temps < 2 )
+      return;
+
+    const CoeffType range = _temp.back() - _temp.front();
+
+    CoeffType min_gap = range;
+    for( unsigned int j = 1; j < n_temps; j++ )
+      min_gap = std::min( min_gap, _temp[j] - _temp[j-1] );
+
+    // cells strictly narrower than the intervals
+    const CoeffType max_n_cells = 4096;
+    if( !(min_gap > 0) || range / min_gap + 1 > max_n_cells )
+      return;
+
+    const unsigned int n_cells = static_cast<unsigned int>( std::ceil( range / min_gap ) ) + 1;
+
+    _lookup_inv_width = n_cells / range;
+
+    _lookup_start.resize( n_cells + 1 );
+    for( unsigned int c = 0; c < n_cells; c++ )
+      _lookup_start[c] = _temp.front() + range * c / n_cells;
+    _lookup_start[n_cells] = _temp.back();
+
+    _lookup_interval.resize( n_cells );
+    _lookup_break.resize( n_cells );
+    for( unsigned int c = 0; c < n_cells; c++ )
+      {
+        _lookup_interval[c] = 0;
+        _lookup_break[c] = _lookup_start[c+1];
+
+        unsigned int n_breaks = 0;
+        for( unsigned int j = 1; j + 1 < n_temps; j++ )
+          {
+            if( _temp[j] < _lookup_start[c] )
+              _lookup_interval[c]++;
+            else if( _temp[j] < _lookup_start[c+1] )
+              {
+                _lookup_break[c] = _temp[j];
+                n_breaks++;
+              }
+          }
+
+        antioch_assert_less_equal( n_breaks, 1 );
+      }
+  }
+
 } // end namespace Antioch
 
 #endif // ANTIOCH_NASA_CURVE_FIT_BASE_H
@@ -81,6 +81,14 @@ namespace Antioch
     //! Checks that curve fits have been specified for all species in the mixture.
     bool check() const;
 
+    //! Counter of the modifications of the curve fits
+    /*!
+     * Incremented by add_curve_fit() and set_curve_fit_coefficient(),
+     * values cached from the coefficients (e.g. by a NASAThermoTable)
+     * are stale when it differs.
+     */
+    unsigned int parameter_version() const;
+
     const ChemicalMixture<CoeffType>& chemical_mixture() const;
 
   protected:
@@ -91,6 +99,8 @@ namespace Antioch
 
     std::vector<CoeffType> _cp_at_200p1;
 
+    unsigned int _parameter_version;
+
   private:
 
     //! Default constructor
@@ -104,7 +114,8 @@ namespace Antioch
   NASAThermoMixture<CoeffType,NASAFit>::NASAThermoMixture( const ChemicalMixture<CoeffType>& chem_mixture )
     : _chem_mixture(chem_mixture),
       _species_curve_fits(chem_mixture.n_species(), NULL),
-      _cp_at_200p1( _species_curve_fits.size() )
+      _cp_at_200p1( _species_curve_fits.size() ),
+      _parameter_version(0)
   {
     return;
   }
@@ -142,6 +153,8 @@ namespace Antioch
     NASAEvaluator<CoeffType,NASAFit> evaluator( *this );
     _cp_at_200p1[s] = evaluator.cp( TempCache<CoeffType>(200.1), s );
 
+    _parameter_version++;
+
     return;
   }
 
@@ -163,6 +176,8 @@ namespace Antioch
     NASAEvaluator<CoeffType,NASAFit> evaluator( *this );
     _cp_at_200p1[s] = evaluator.cp( TempCache<CoeffType>(200.1), s );
 
+    _parameter_version++;
+
     return;
   }
 
@@ -181,6 +196,8 @@ namespace Antioch
     // Our cp may have changed, so reevaluate the cached cp(200.1)
     NASAEvaluator<CoeffType,NASAFit> evaluator( *this );
     _cp_at_200p1[s] = evaluator.cp( TempCache<CoeffType>(200.1), s );
+
+    _parameter_version++;
   }
 
 
@@ -200,6 +217,13 @@ namespace Antioch
     return valid;
   }
 
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int NASAThermoMixture<CoeffType,NASAFit>::parameter_version() const
+  {
+    return _parameter_version;
+  }
+
   template<typename CoeffType, typename NASAFit>
   inline
   const NASAFit& NASAThermoMixture<CoeffType,NASAFit>::curve_fit( unsigned int s ) const
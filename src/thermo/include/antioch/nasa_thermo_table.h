@@ -0,0 +1,776 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_NASA_THERMO_TABLE_H
+#define ANTIOCH_NASA_THERMO_TABLE_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/nasa_mixture.h"
+#include "antioch/nasa7_curve_fit.h"
+#include "antioch/nasa9_curve_fit.h"
+#include "antioch/temp_cache.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace Antioch
+{
+
+  /*!
+   * Coefficients of all the species of a NASAThermoMixture, packed
+   * for whole-mixture evaluations at a scalar temperature.
+   *
+   * Each property of each curve fit interval is a linear combination
+   * of a few functions of T (the Monomial's), with weights computed
+   * once from the curve fit coefficients. The weights are stored
+   * species-contiguous: for a property, an interval and a monomial,
+   * the weights of all the species are one array. When every species
+   * lies in the same interval (the usual case, species mostly share
+   * their breakpoints), a property of the whole mixture is then a few
+   * axpy sweeps over the species, with no per-species interval search
+   * or indirection. Otherwise the weights are gathered species by
+   * species.
+   *
+   * The intervals follow NASACurveFitBase::interval(), a temperature
+   * on a breakpoint or outside of the fit range uses the first
+   * interval. The results equal the ones of NASAEvaluator up to
+   * round-off.
+   *
+   * thermo_properties() fills several properties at once, sharing the
+   * functions of T and the interval search between them.
+   *
+   * The table is a snapshot of the curve fits, any modification of the
+   * mixture requires a call to build() before the next evaluation.
+   */
+  template<typename CoeffType=double, typename NASAFit = NASA9CurveFit<CoeffType> >
+  class NASAThermoTable
+  {
+  public:
+
+    //! Properties stored in the table
+    enum Property { CP_OVER_R = 0,
+                    H_OVER_RT,
+                    S_OVER_R,
+                    H_RT_MINUS_S_R,
+                    DH_RT_MINUS_S_R_DT,
+                    N_PROPERTIES };
+
+    //! Functions of T the properties are linear combinations of
+    enum Monomial { INV_T3 = 0,
+                    LNT_OVER_T2,
+                    INV_T2,
+                    INV_T,
+                    LNT_OVER_T,
+                    LNT,
+                    ONE,
+                    T1,
+                    T2,
+                    T3,
+                    T4,
+                    N_MONOMIALS };
+
+    //! Constructor, builds the table.
+    NASAThermoTable( const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture );
+
+    ~NASAThermoTable();
+
+    //! (Re)packs the curve fits of the mixture.
+    /*!
+     * The evaluations check NASAThermoMixture::parameter_version(), and
+     * error out if the mixture was modified since the last build().
+     */
+    void build();
+
+    //! \returns the number of species.
+    unsigned int n_species() const;
+
+    //! \returns the largest number of curve fit intervals of the species.
+    unsigned int n_intervals() const;
+
+    //! \returns the packed mixture.
+    const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture() const;
+
+    //! Property \p p of all species
+    template<typename StateType, typename VectorStateType>
+    void evaluate( Property p, const TempCache<StateType>& cache, VectorStateType& values ) const;
+
+    //! cp, h, h/RT - s/R and its derivative of all species, in one pass
+    /*!
+     * Same values as cp(), h(), h_RT_minus_s_R() and
+     * dh_RT_minus_s_R_dT(), the NULL properties are skipped.
+     */
+    template<typename StateType, typename VectorStateType>
+    void thermo_properties( const TempCache<StateType>& cache,
+                            VectorStateType* cp,
+                            VectorStateType* h,
+                            VectorStateType* h_RT_minus_s_R,
+                            VectorStateType* dh_RT_minus_s_R_dT ) const;
+
+    //! Cp over R of all species
+    template<typename StateType, typename VectorStateType>
+    void cp_over_R( const TempCache<StateType>& cache, VectorStateType& cp_over_R ) const;
+
+    //! h over RT of all species
+    template<typename StateType, typename VectorStateType>
+    void h_over_RT( const TempCache<StateType>& cache, VectorStateType& h_over_RT ) const;
+
+    //! s over R of all species
+    template<typename StateType, typename VectorStateType>
+    void s_over_R( const TempCache<StateType>& cache, VectorStateType& s_over_R ) const;
+
+    //! h over RT minus s over R of all species
+    template<typename StateType, typename VectorStateType>
+    void h_RT_minus_s_R( const TempCache<StateType>& cache, VectorStateType& h_RT_minus_s_R ) const;
+
+    //! Temperature derivative of h over RT minus s over R of all species
+    template<typename StateType, typename VectorStateType>
+    void dh_RT_minus_s_R_dT( const TempCache<StateType>& cache, VectorStateType& dh_RT_minus_s_R_dT ) const;
+
+    //! Specific heat of all species, as NASAEvaluator::cp()
+    template<typename StateType, typename VectorStateType>
+    void cp( const TempCache<StateType>& cache, VectorStateType& cp ) const;
+
+    //! Specific enthalpy of all species, as NASAEvaluator::h()
+    template<typename StateType, typename VectorStateType>
+    void h( const TempCache<StateType>& cache, VectorStateType& h ) const;
+
+    //! Specific entropy of all species, at the reference pressure
+    template<typename StateType, typename VectorStateType>
+    void s( const TempCache<StateType>& cache, VectorStateType& s ) const;
+
+  protected:
+
+    //! Fills \p m with the values of the monomials
+    template<typename StateType>
+    void monomials( const TempCache<StateType>& cache, StateType* m ) const;
+
+    //! Property \p p of all species, all in interval \p interval
+    template<typename StateType, typename VectorStateType>
+    void sweep( Property p, const StateType* m, unsigned int interval, VectorStateType& values ) const;
+
+    //! Property \p p of species \p s, in interval \p interval
+    template<typename StateType>
+    StateType species_value( Property p, const StateType* m, unsigned int interval, unsigned int s ) const;
+
+    //! The interval of species \p s at temperature \p T
+    template<typename StateType>
+    unsigned int interval( const StateType& T, unsigned int s ) const;
+
+    //! The interval of all species at temperature \p T, n_intervals() if they differ
+    /*!
+     * One lookup in the common bounds, the species are only searched
+     * one by one when \p T lies in none of the common intervals.
+     */
+    template<typename StateType>
+    unsigned int common_interval( const StateType& T ) const;
+
+    void check_version() const;
+
+    const NASAThermoMixture<CoeffType,NASAFit>& _nasa_mixture;
+
+    unsigned int _n_species;
+
+    unsigned int _n_intervals;
+
+    //! NASAThermoMixture::parameter_version() at the last build()
+    unsigned int _built_version;
+
+    //! Interval bounds, (n_intervals() + 1) x n_species
+    /*!
+     * Species with fewer intervals repeat their last breakpoint,
+     * no temperature lies in their padding intervals.
+     */
+    std::vector<CoeffType> _temp;
+
+    //! Bounds of the intervals common to all the species, n_intervals() each
+    /*!
+     * Largest lower and smallest upper bound of each interval over the
+     * species: all species lie in interval i for temperatures between
+     * _common_lower[i] and _common_upper[i]. The range is empty when the
+     * breakpoints of the species differ too much.
+     */
+    std::vector<CoeffType> _common_lower;
+    std::vector<CoeffType> _common_upper;
+
+    //! Monomials used by each property
+    std::vector<unsigned int> _terms[N_PROPERTIES];
+
+    //! Weights of each property, n_intervals() x _terms[p].size() x n_species
+    std::vector<CoeffType> _weights[N_PROPERTIES];
+
+    std::vector<CoeffType> _R;
+
+    std::vector<CoeffType> _cp_at_200p1;
+
+  private:
+
+    //! Default constructor
+    /*! Private to force to user to supply a NASAThermoMixture object.*/
+    NASAThermoTable();
+
+  };
+
+  namespace AntiochPrivate
+  {
+    //! Weights of the NASA7 properties on the NASAThermoTable monomials
+    template<typename CoeffType, typename NASAFit>
+    void nasa_thermo_table_weights( const NASA7CurveFit<CoeffType>& /*fit*/,
+                                    const CoeffType* a,
+                                    CoeffType w[][NASAThermoTable<CoeffType,NASAFit>::N_MONOMIALS] )
+    {
+      typedef NASAThermoTable<CoeffType,NASAFit> Table;
+
+      w[Table::CP_OVER_R][Table::ONE] = a[0];
+      w[Table::CP_OVER_R][Table::T1]  = a[1];
+      w[Table::CP_OVER_R][Table::T2]  = a[2];
+      w[Table::CP_OVER_R][Table::T3]  = a[3];
+      w[Table::CP_OVER_R][Table::T4]  = a[4];
+
+      w[Table::H_OVER_RT][Table::INV_T] = a[5];
+      w[Table::H_OVER_RT][Table::ONE]   = a[0];
+      w[Table::H_OVER_RT][Table::T1]    = a[1]/2;
+      w[Table::H_OVER_RT][Table::T2]    = a[2]/3;
+      w[Table::H_OVER_RT][Table::T3]    = a[3]/4;
+      w[Table::H_OVER_RT][Table::T4]    = a[4]/5;
+
+      w[Table::S_OVER_R][Table::LNT] = a[0];
+      w[Table::S_OVER_R][Table::ONE] = a[6];
+      w[Table::S_OVER_R][Table::T1]  = a[1];
+      w[Table::S_OVER_R][Table::T2]  = a[2]/2;
+      w[Table::S_OVER_R][Table::T3]  = a[3]/3;
+      w[Table::S_OVER_R][Table::T4]  = a[4]/4;
+
+      w[Table::H_RT_MINUS_S_R][Table::INV_T] = a[5];
+      w[Table::H_RT_MINUS_S_R][Table::LNT]   = -a[0];
+      w[Table::H_RT_MINUS_S_R][Table::ONE]   = a[0] - a[6];
+      w[Table::H_RT_MINUS_S_R][Table::T1]    = -a[1]/2;
+      w[Table::H_RT_MINUS_S_R][Table::T2]    = -a[2]/6;
+      w[Table::H_RT_MINUS_S_R][Table::T3]    = -a[3]/12;
+      w[Table::H_RT_MINUS_S_R][Table::T4]    = -a[4]/20;
+
+      w[Table::DH_RT_MINUS_S_R_DT][Table::INV_T2] = -a[5];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::INV_T]  = -a[0];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::ONE]    = -a[1]/2;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T1]     = -a[2]/3;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T2]     = -a[3]/4;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T3]     = -a[4]/5;
+    }
+
+    //! Weights of the NASA9 properties on the NASAThermoTable monomials
+    template<typename CoeffType, typename NASAFit>
+    void nasa_thermo_table_weights( const NASA9CurveFit<CoeffType>& /*fit*/,
+                                    const CoeffType* a,
+                                    CoeffType w[][NASAThermoTable<CoeffType,NASAFit>::N_MONOMIALS] )
+    {
+      typedef NASAThermoTable<CoeffType,NASAFit> Table;
+
+      w[Table::CP_OVER_R][Table::INV_T2] = a[0];
+      w[Table::CP_OVER_R][Table::INV_T]  = a[1];
+      w[Table::CP_OVER_R][Table::ONE]    = a[2];
+      w[Table::CP_OVER_R][Table::T1]     = a[3];
+      w[Table::CP_OVER_R][Table::T2]     = a[4];
+      w[Table::CP_OVER_R][Table::T3]     = a[5];
+      w[Table::CP_OVER_R][Table::T4]     = a[6];
+
+      w[Table::H_OVER_RT][Table::INV_T2]     = -a[0];
+      w[Table::H_OVER_RT][Table::INV_T]      = a[7];
+      w[Table::H_OVER_RT][Table::LNT_OVER_T] = a[1];
+      w[Table::H_OVER_RT][Table::ONE]        = a[2];
+      w[Table::H_OVER_RT][Table::T1]         = a[3]/2;
+      w[Table::H_OVER_RT][Table::T2]         = a[4]/3;
+      w[Table::H_OVER_RT][Table::T3]         = a[5]/4;
+      w[Table::H_OVER_RT][Table::T4]         = a[6]/5;
+
+      w[Table::S_OVER_R][Table::INV_T2] = -a[0]/2;
+      w[Table::S_OVER_R][Table::INV_T]  = -a[1];
+      w[Table::S_OVER_R][Table::LNT]    = a[2];
+      w[Table::S_OVER_R][Table::ONE]    = a[8];
+      w[Table::S_OVER_R][Table::T1]     = a[3];
+      w[Table::S_OVER_R][Table::T2]     = a[4]/2;
+      w[Table::S_OVER_R][Table::T3]     = a[5]/3;
+      w[Table::S_OVER_R][Table::T4]     = a[6]/4;
+
+      w[Table::H_RT_MINUS_S_R][Table::INV_T2]     = -a[0]/2;
+      w[Table::H_RT_MINUS_S_R][Table::INV_T]      = a[1] + a[7];
+      w[Table::H_RT_MINUS_S_R][Table::LNT_OVER_T] = a[1];
+      w[Table::H_RT_MINUS_S_R][Table::LNT]        = -a[2];
+      w[Table::H_RT_MINUS_S_R][Table::ONE]        = a[2] - a[8];
+      w[Table::H_RT_MINUS_S_R][Table::T1]         = -a[3]/2;
+      w[Table::H_RT_MINUS_S_R][Table::T2]         = -a[4]/6;
+      w[Table::H_RT_MINUS_S_R][Table::T3]         = -a[5]/12;
+      w[Table::H_RT_MINUS_S_R][Table::T4]         = -a[6]/20;
+
+      w[Table::DH_RT_MINUS_S_R_DT][Table::INV_T3]      = a[0];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::INV_T2]      = -a[7];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::LNT_OVER_T2] = -a[1];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::INV_T]       = -a[2];
+      w[Table::DH_RT_MINUS_S_R_DT][Table::ONE]         = -a[3]/2;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T1]          = -a[4]/3;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T2]          = -a[5]/4;
+      w[Table::DH_RT_MINUS_S_R_DT][Table::T3]          = -a[6]/5;
+    }
+  } // end namespace AntiochPrivate
+
+  /* --------------------- Constructor/Destructor -----------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  NASAThermoTable<CoeffType,NASAFit>::NASAThermoTable( const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture )
+    : _nasa_mixture(nasa_mixture),
+      _n_species(0),
+      _n_intervals(0),
+      _built_version(0)
+  {
+    this->build();
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  NASAThermoTable<CoeffType,NASAFit>::~NASAThermoTable()
+  {
+    return;
+  }
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int NASAThermoTable<CoeffType,NASAFit>::n_species() const
+  {
+    return _n_species;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int NASAThermoTable<CoeffType,NASAFit>::n_intervals() const
+  {
+    return _n_intervals;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  const NASAThermoMixture<CoeffType,NASAFit>& NASAThermoTable<CoeffType,NASAFit>::nasa_mixture() const
+  {
+    return _nasa_mixture;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::build()
+  {
+    antioch_assert( _nasa_mixture.check() );
+
+    const ChemicalMixture<CoeffType>& chem_mixture = _nasa_mixture.chemical_mixture();
+
+    _n_species = chem_mixture.n_species();
+    _n_intervals = 0;
+    for( unsigned int s = 0; s < _n_species; s++ )
+      _n_intervals = std::max( _n_intervals, _nasa_mixture.curve_fit(s).n_intervals() );
+
+    const unsigned int n_species = _n_species;
+
+    _temp.assign( (_n_intervals + 1) * n_species, 0 );
+    _R.resize( n_species );
+    _cp_at_200p1.resize( n_species );
+
+    // all the weights, before dropping the monomials unused by a property
+    std::vector<CoeffType> weights( _n_intervals * N_PROPERTIES * N_MONOMIALS * n_species, 0 );
+    std::vector<bool> used( N_PROPERTIES * N_MONOMIALS, false );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const NASAFit& fit = _nasa_mixture.curve_fit(s);
+        const std::vector<CoeffType>& temp = fit.temperatures();
+
+        for( unsigned int j = 0; j <= _n_intervals; j++ )
+          _temp[j*n_species + s] = temp[std::min( j, static_cast<unsigned int>(temp.size()) - 1 )];
+
+        for( unsigned int i = 0; i < fit.n_intervals(); i++ )
+          {
+            CoeffType w[N_PROPERTIES][N_MONOMIALS];
+            std::fill( &w[0][0], &w[0][0] + N_PROPERTIES * N_MONOMIALS, CoeffType(0) );
+
+            AntiochPrivate::nasa_thermo_table_weights<CoeffType,NASAFit>( fit, fit.coefficients(i), w );
+
+            for( unsigned int p = 0; p < N_PROPERTIES; p++ )
+              for( unsigned int m = 0; m < N_MONOMIALS; m++ )
+                {
+                  weights[((i*N_PROPERTIES + p)*N_MONOMIALS + m)*n_species + s] = w[p][m];
+                  if( w[p][m] != CoeffType(0) )
+                    used[p*N_MONOMIALS + m] = true;
+                }
+          }
+
+        _R[s] = chem_mixture.R(s);
+        _cp_at_200p1[s] = _nasa_mixture.cp_at_200p1(s);
+      }
+
+    _common_lower.resize( _n_intervals );
+    _common_upper.resize( _n_intervals );
+    for( unsigned int i = 0; i < _n_intervals; i++ )
+      {
+        _common_lower[i] = *std::max_element( _temp.begin() + i*n_species, _temp.begin() + (i+1)*n_species );
+        _common_upper[i] = *std::min_element( _temp.begin() + (i+1)*n_species, _temp.begin() + (i+2)*n_species );
+      }
+
+    for( unsigned int p = 0; p < N_PROPERTIES; p++ )
+      {
+        _terms[p].clear();
+        for( unsigned int m = 0; m < N_MONOMIALS; m++ )
+          if( used[p*N_MONOMIALS + m] )
+            _terms[p].push_back(m);
+
+        // all zero fits, keep one monomial
+        if( _terms[p].empty() )
+          _terms[p].push_back(ONE);
+
+        const unsigned int n_terms = _terms[p].size();
+
+        _weights[p].resize( _n_intervals * n_terms * n_species );
+        for( unsigned int i = 0; i < _n_intervals; i++ )
+          for( unsigned int t = 0; t < n_terms; t++ )
+            std::copy( weights.begin() + ((i*N_PROPERTIES + p)*N_MONOMIALS + _terms[p][t])*n_species,
+                       weights.begin() + ((i*N_PROPERTIES + p)*N_MONOMIALS + _terms[p][t] + 1)*n_species,
+                       _weights[p].begin() + (i*n_terms + t)*n_species );
+      }
+
+    _built_version = _nasa_mixture.parameter_version();
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::check_version() const
+  {
+    if( _nasa_mixture.parameter_version() != _built_version )
+      antioch_error_msg("The NASA mixture was modified after the thermo table was built, build() must be called again.");
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::monomials( const TempCache<StateType>& cache, StateType* m ) const
+  {
+    m[INV_T]       = StateType(1)/cache.T;
+    m[INV_T2]      = m[INV_T]*m[INV_T];
+    m[INV_T3]      = m[INV_T2]*m[INV_T];
+    m[LNT]         = cache.lnT;
+    m[LNT_OVER_T]  = cache.lnT*m[INV_T];
+    m[LNT_OVER_T2] = cache.lnT*m[INV_T2];
+    m[ONE]        = 1;
+    m[T1]         = cache.T;
+    m[T2]         = cache.T2;
+    m[T3]         = cache.T3;
+    m[T4]         = cache.T4;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType>
+  inline
+  unsigned int NASAThermoTable<CoeffType,NASAFit>::interval( const StateType& T, unsigned int s ) const
+  {
+    unsigned int interval = 0;
+    for( unsigned int i = 0; i < _n_intervals; i++ )
+      if( T > _temp[i*_n_species + s] && T < _temp[(i+1)*_n_species + s] )
+        interval = i;
+
+    return interval;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType>
+  inline
+  unsigned int NASAThermoTable<CoeffType,NASAFit>::common_interval( const StateType& T ) const
+  {
+    for( unsigned int i = 0; i < _n_intervals; i++ )
+      if( T > _common_lower[i] && T < _common_upper[i] )
+        return i;
+
+    // on a breakpoint, out of the fit ranges, or
+    // between breakpoints of different species
+    const unsigned int first = this->interval(T,0);
+    for( unsigned int s = 1; s < _n_species; s++ )
+      if( this->interval(T,s) != first )
+        return _n_intervals;
+
+    return first;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::sweep( Property p,
+                                                  const StateType* m,
+                                                  unsigned int interval,
+                                                  VectorStateType& values ) const
+  {
+    const std::vector<unsigned int>& terms = _terms[p];
+    const unsigned int n_terms = terms.size();
+    const unsigned int n_species = _n_species;
+
+    // one axpy per monomial over all the species
+    const CoeffType* w = &_weights[p][interval*n_terms*n_species];
+
+    const StateType m0 = m[terms[0]];
+    for( unsigned int s = 0; s < n_species; s++ )
+      values[s] = w[s]*m0;
+
+    for( unsigned int t = 1; t < n_terms; t++ )
+      {
+        const CoeffType* wt = w + t*n_species;
+        const StateType mt = m[terms[t]];
+        for( unsigned int s = 0; s < n_species; s++ )
+          values[s] += wt[s]*mt;
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType>
+  inline
+  StateType NASAThermoTable<CoeffType,NASAFit>::species_value( Property p,
+                                                               const StateType* m,
+                                                               unsigned int interval,
+                                                               unsigned int s ) const
+  {
+    const std::vector<unsigned int>& terms = _terms[p];
+    const unsigned int n_terms = terms.size();
+    const unsigned int n_species = _n_species;
+
+    const CoeffType* w = &_weights[p][interval*n_terms*n_species + s];
+
+    StateType value = w[0]*m[terms[0]];
+    for( unsigned int t = 1; t < n_terms; t++ )
+      value += w[t*n_species]*m[terms[t]];
+
+    return value;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::evaluate( Property p,
+                                                     const TempCache<StateType>& cache,
+                                                     VectorStateType& values ) const
+  {
+    antioch_assert_less( p, N_PROPERTIES );
+    antioch_assert_equal_to( values.size(), _n_species );
+
+    this->check_version();
+
+    if( _n_species == 0 )
+      return;
+
+    StateType m[N_MONOMIALS];
+    this->monomials( cache, m );
+
+    const unsigned int common = this->common_interval( cache.T );
+
+    if( common < _n_intervals )
+      this->sweep( p, m, common, values );
+    else
+      for( unsigned int s = 0; s < _n_species; s++ )
+        values[s] = this->species_value( p, m, this->interval(cache.T,s), s );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::thermo_properties( const TempCache<StateType>& cache,
+                                                              VectorStateType* cp,
+                                                              VectorStateType* h,
+                                                              VectorStateType* h_RT_minus_s_R,
+                                                              VectorStateType* dh_RT_minus_s_R_dT ) const
+  {
+    this->check_version();
+
+    // T < 200.1 ? cp_at_200p1 : R * cp_over_R
+    const bool clamp_cp = ( cache.T < StateType(200.1) );
+
+    Property properties[4];
+    VectorStateType* values[4];
+    unsigned int n_properties = 0;
+
+    if( cp && !clamp_cp )
+      {
+        properties[n_properties] = CP_OVER_R;
+        values[n_properties++] = cp;
+      }
+    if( h )
+      {
+        properties[n_properties] = H_OVER_RT;
+        values[n_properties++] = h;
+      }
+    if( h_RT_minus_s_R )
+      {
+        properties[n_properties] = H_RT_MINUS_S_R;
+        values[n_properties++] = h_RT_minus_s_R;
+      }
+    if( dh_RT_minus_s_R_dT )
+      {
+        properties[n_properties] = DH_RT_MINUS_S_R_DT;
+        values[n_properties++] = dh_RT_minus_s_R_dT;
+      }
+
+    for( unsigned int k = 0; k < n_properties; k++ )
+      antioch_assert_equal_to( values[k]->size(), _n_species );
+
+    if( _n_species == 0 )
+      return;
+
+    StateType m[N_MONOMIALS];
+    this->monomials( cache, m );
+
+    const unsigned int common = this->common_interval( cache.T );
+
+    if( common < _n_intervals )
+      {
+        for( unsigned int k = 0; k < n_properties; k++ )
+          this->sweep( properties[k], m, common, *values[k] );
+      }
+    else
+      {
+        for( unsigned int s = 0; s < _n_species; s++ )
+          {
+            const unsigned int interval = this->interval(cache.T,s);
+            for( unsigned int k = 0; k < n_properties; k++ )
+              (*values[k])[s] = this->species_value( properties[k], m, interval, s );
+          }
+      }
+
+    if( cp )
+      {
+        antioch_assert_equal_to( cp->size(), _n_species );
+
+        if( clamp_cp )
+          for( unsigned int s = 0; s < _n_species; s++ )
+            (*cp)[s] = _cp_at_200p1[s];
+        else
+          for( unsigned int s = 0; s < _n_species; s++ )
+            (*cp)[s] *= _R[s];
+      }
+
+    if( h )
+      for( unsigned int s = 0; s < _n_species; s++ )
+        (*h)[s] = _R[s]*cache.T*(*h)[s];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::cp_over_R( const TempCache<StateType>& cache,
+                                                      VectorStateType& cp_over_R ) const
+  {
+    this->evaluate( CP_OVER_R, cache, cp_over_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::h_over_RT( const TempCache<StateType>& cache,
+                                                      VectorStateType& h_over_RT ) const
+  {
+    this->evaluate( H_OVER_RT, cache, h_over_RT );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::s_over_R( const TempCache<StateType>& cache,
+                                                     VectorStateType& s_over_R ) const
+  {
+    this->evaluate( S_OVER_R, cache, s_over_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::h_RT_minus_s_R( const TempCache<StateType>& cache,
+                                                           VectorStateType& h_RT_minus_s_R ) const
+  {
+    this->evaluate( H_RT_MINUS_S_R, cache, h_RT_minus_s_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::dh_RT_minus_s_R_dT( const TempCache<StateType>& cache,
+                                                               VectorStateType& dh_RT_minus_s_R_dT ) const
+  {
+    this->evaluate( DH_RT_MINUS_S_R_DT, cache, dh_RT_minus_s_R_dT );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::cp( const TempCache<StateType>& cache,
+                                               VectorStateType& cp ) const
+  {
+    antioch_assert_equal_to( cp.size(), _n_species );
+
+    // T < 200.1 ? cp_at_200p1 : R * cp_over_R
+    if( cache.T < StateType(200.1) )
+      {
+        this->check_version();
+
+        for( unsigned int s = 0; s < _n_species; s++ )
+          cp[s] = _cp_at_200p1[s];
+
+        return;
+      }
+
+    this->evaluate( CP_OVER_R, cache, cp );
+
+    for( unsigned int s = 0; s < _n_species; s++ )
+      cp[s] *= _R[s];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::h( const TempCache<StateType>& cache,
+                                              VectorStateType& h ) const
+  {
+    this->evaluate( H_OVER_RT, cache, h );
+
+    for( unsigned int s = 0; s < _n_species; s++ )
+      h[s] = _R[s]*cache.T*h[s];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void NASAThermoTable<CoeffType,NASAFit>::s( const TempCache<StateType>& cache,
+                                              VectorStateType& s ) const
+  {
+    this->evaluate( S_OVER_R, cache, s );
+
+    for( unsigned int i = 0; i < _n_species; i++ )
+      s[i] *= _R[i];
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_NASA_THERMO_TABLE_H
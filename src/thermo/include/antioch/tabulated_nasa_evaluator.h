@@ -0,0 +1,666 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_TABULATED_NASA_EVALUATOR_H
+#define ANTIOCH_TABULATED_NASA_EVALUATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/nasa_mixture.h"
+#include "antioch/nasa_thermo_table.h"
+#include "antioch/temp_cache.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Antioch
+{
+
+  /*!
+   * Thermodynamics of all the species of a NASAThermoMixture,
+   * interpolated on a uniform grid in T.
+   *
+   * cp/R, h/RT, s/R and h/RT - s/R are tabulated between
+   * \f$T_{\min}\f$ and \f$T_{\max}\f$, each grid cell holds, for every
+   * species, the cubic Hermite polynomial matching the values and the
+   * exact slopes of the curve fit at the ends of the cell. An
+   * evaluation is a cell lookup and a cubic per species.
+   *
+   * The interpolation error in a cell of width \f$\Delta T\f$ is
+   * bounded by
+   * \f[
+   *   |f - p| \le \frac{\Delta T^4}{384} \max_{cell} |f^{(4)}|
+   * \f]
+   * where the fourth derivative of the curve fit is bounded from its
+   * decomposition on the NASAThermoTable monomials. error_bound()
+   * is the largest such bound over the species and the cells, it
+   * guarantees the tabulated values up to round-off.
+   *
+   * The curve fits are discontinuous at their breakpoints and at the
+   * top of their range (NASACurveFitBase::interval() falls back to the
+   * first interval there). The cells holding such a temperature, ends
+   * included, are not interpolated for that species: the curve fit is
+   * evaluated instead, so the results match NASAEvaluator everywhere.
+   *
+   * cp(), h() and s() follow NASAThermoTable, with the cp clamp below 200.1 K.
+   *
+   * The table is a snapshot of the curve fits, any modification of the
+   * mixture requires a call to tabulate() before the next evaluation.
+   */
+  template<typename CoeffType=double, typename NASAFit = NASA9CurveFit<CoeffType> >
+  class TabulatedNASAEvaluator
+  {
+  public:
+
+    //! Tabulated properties, in the order of NASAThermoTable::Property
+    enum Property { CP_OVER_R = 0,
+                    H_OVER_RT,
+                    S_OVER_R,
+                    H_RT_MINUS_S_R,
+                    N_PROPERTIES };
+
+    //! Constructor, nothing is tabulated yet
+    TabulatedNASAEvaluator( const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture );
+
+    ~TabulatedNASAEvaluator();
+
+    //! Tabulates on \p n_intervals cells between \p T_min and \p T_max
+    void tabulate( const CoeffType& T_min,
+                   const CoeffType& T_max,
+                   unsigned int n_intervals );
+
+    //! Tabulates with the fewest cells whose error_bound() is below \p tolerance
+    /*!
+     * For all the properties, \p tolerance is an absolute error on
+     * the nondimensional properties.
+     */
+    void tabulate_to_tolerance( const CoeffType& T_min,
+                                const CoeffType& T_max,
+                                const CoeffType& tolerance );
+
+    //! \returns true if tabulate() was called for the current mixture parameters
+    bool is_tabulated() const;
+
+    //! \returns the number of species.
+    unsigned int n_species() const;
+
+    //! \returns the number of cells of the grid.
+    unsigned int n_intervals() const;
+
+    CoeffType T_min() const;
+
+    CoeffType T_max() const;
+
+    //! Bound of the absolute interpolation error of property \p p
+    CoeffType error_bound( Property p ) const;
+
+    //! \returns the tabulated mixture.
+    const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture() const;
+
+    //! Property \p p of all species
+    /*!
+     * \p cache.T must be within [T_min(), T_max()].
+     */
+    template<typename StateType, typename VectorStateType>
+    void evaluate( Property p, const TempCache<StateType>& cache, VectorStateType& values ) const;
+
+    //! Cp over R of all species
+    template<typename StateType, typename VectorStateType>
+    void cp_over_R( const TempCache<StateType>& cache, VectorStateType& cp_over_R ) const;
+
+    //! h over RT of all species
+    template<typename StateType, typename VectorStateType>
+    void h_over_RT( const TempCache<StateType>& cache, VectorStateType& h_over_RT ) const;
+
+    //! s over R of all species
+    template<typename StateType, typename VectorStateType>
+    void s_over_R( const TempCache<StateType>& cache, VectorStateType& s_over_R ) const;
+
+    //! h over RT minus s over R of all species
+    template<typename StateType, typename VectorStateType>
+    void h_RT_minus_s_R( const TempCache<StateType>& cache, VectorStateType& h_RT_minus_s_R ) const;
+
+    //! Specific heat of all species, as NASAEvaluator::cp()
+    template<typename StateType, typename VectorStateType>
+    void cp( const TempCache<StateType>& cache, VectorStateType& cp ) const;
+
+    //! Specific enthalpy of all species, as NASAEvaluator::h()
+    template<typename StateType, typename VectorStateType>
+    void h( const TempCache<StateType>& cache, VectorStateType& h ) const;
+
+    //! Specific entropy of all species
+    template<typename StateType, typename VectorStateType>
+    void s( const TempCache<StateType>& cache, VectorStateType& s ) const;
+
+  protected:
+
+    typedef NASAThermoTable<CoeffType,NASAFit> Table;
+
+    //! Value and temperature derivative of the monomials at \p T
+    void monomials( const CoeffType& T, CoeffType* m, CoeffType* dm ) const;
+
+    //! Bound of the fourth derivative of the monomials over [\p T_a, \p T_b]
+    void monomials_d4_bound( const CoeffType& T_a, const CoeffType& T_b, CoeffType* d4 ) const;
+
+    //! Property \p p of species \p s from its curve fit
+    template<typename StateType>
+    StateType exact_value( Property p, const TempCache<StateType>& cache, unsigned int s ) const;
+
+    //! Checks the table and that interpolation at \p T is possible
+    void check_temperature( const CoeffType& T ) const;
+
+    const NASAThermoMixture<CoeffType,NASAFit>& _nasa_mixture;
+
+    unsigned int _n_species;
+
+    //! NASAThermoMixture::parameter_version() at the last tabulate()
+    unsigned int _version;
+
+    bool _tabulated;
+
+    CoeffType _T_min;
+    CoeffType _T_max;
+    CoeffType _dT;
+    CoeffType _inv_dT;
+    unsigned int _n_intervals;
+
+    //! Cubic coefficients of each property, n_intervals() x 4 x n_species
+    /*!
+     * In the local coordinate t in [0,1] of the cell,
+     * p(t) = c0 + c1 t + c2 t^2 + c3 t^3.
+     */
+    std::vector<CoeffType> _coeffs[N_PROPERTIES];
+
+    //! Species evaluated from their curve fit, per cell
+    /*!
+     * Cell c holds the species _exact_species[_exact_start[c]] to
+     * _exact_species[_exact_start[c+1]-1].
+     */
+    std::vector<unsigned int> _exact_start;
+    std::vector<unsigned int> _exact_species;
+
+    CoeffType _error_bound[N_PROPERTIES];
+
+    std::vector<CoeffType> _R;
+
+    std::vector<CoeffType> _cp_at_200p1;
+
+  private:
+
+    //! Default constructor
+    /*! Private to force to user to supply a NASAThermoMixture object.*/
+    TabulatedNASAEvaluator();
+
+  };
+
+  /* --------------------- Constructor/Destructor -----------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  TabulatedNASAEvaluator<CoeffType,NASAFit>::TabulatedNASAEvaluator( const NASAThermoMixture<CoeffType,NASAFit>& nasa_mixture )
+    : _nasa_mixture(nasa_mixture),
+      _n_species(nasa_mixture.chemical_mixture().n_species()),
+      _version(0),
+      _tabulated(false),
+      _T_min(0),
+      _T_max(0),
+      _dT(0),
+      _inv_dT(0),
+      _n_intervals(0)
+  {
+    std::fill( _error_bound, _error_bound + N_PROPERTIES, CoeffType(0) );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  TabulatedNASAEvaluator<CoeffType,NASAFit>::~TabulatedNASAEvaluator()
+  {
+    return;
+  }
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  bool TabulatedNASAEvaluator<CoeffType,NASAFit>::is_tabulated() const
+  {
+    return _tabulated && _version == _nasa_mixture.parameter_version();
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int TabulatedNASAEvaluator<CoeffType,NASAFit>::n_species() const
+  {
+    return _n_species;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int TabulatedNASAEvaluator<CoeffType,NASAFit>::n_intervals() const
+  {
+    return _n_intervals;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  CoeffType TabulatedNASAEvaluator<CoeffType,NASAFit>::T_min() const
+  {
+    return _T_min;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  CoeffType TabulatedNASAEvaluator<CoeffType,NASAFit>::T_max() const
+  {
+    return _T_max;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  CoeffType TabulatedNASAEvaluator<CoeffType,NASAFit>::error_bound( Property p ) const
+  {
+    antioch_assert_less( p, N_PROPERTIES );
+    return _error_bound[p];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  const NASAThermoMixture<CoeffType,NASAFit>& TabulatedNASAEvaluator<CoeffType,NASAFit>::nasa_mixture() const
+  {
+    return _nasa_mixture;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::monomials( const CoeffType& T, CoeffType* m, CoeffType* dm ) const
+  {
+    using std::log;
+
+    const CoeffType inv_T = 1/T;
+    const CoeffType lnT = log(T);
+
+    m[Table::INV_T3]      = inv_T*inv_T*inv_T;
+    m[Table::INV_T2]      = inv_T*inv_T;
+    m[Table::INV_T]       = inv_T;
+    m[Table::LNT_OVER_T2] = lnT*m[Table::INV_T2];
+    m[Table::LNT_OVER_T]  = lnT*inv_T;
+    m[Table::LNT]         = lnT;
+    m[Table::ONE]         = 1;
+    m[Table::T1]          = T;
+    m[Table::T2]          = T*T;
+    m[Table::T3]          = T*T*T;
+    m[Table::T4]          = m[Table::T2]*m[Table::T2];
+
+    dm[Table::INV_T3]      = -3*m[Table::INV_T3]*inv_T;
+    dm[Table::INV_T2]      = -2*m[Table::INV_T3];
+    dm[Table::INV_T]       = -m[Table::INV_T2];
+    dm[Table::LNT_OVER_T2] = (1 - 2*lnT)*m[Table::INV_T3];
+    dm[Table::LNT_OVER_T]  = (1 - lnT)*m[Table::INV_T2];
+    dm[Table::LNT]         = inv_T;
+    dm[Table::ONE]         = 0;
+    dm[Table::T1]          = 1;
+    dm[Table::T2]          = 2*T;
+    dm[Table::T3]          = 3*m[Table::T2];
+    dm[Table::T4]          = 4*m[Table::T3];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::monomials_d4_bound( const CoeffType& T_a,
+                                                                      const CoeffType& T_b,
+                                                                      CoeffType* d4 ) const
+  {
+    using std::abs;
+    using std::log;
+    using std::max;
+    using std::pow;
+
+    antioch_assert_greater( T_a, CoeffType(0) );
+
+    // the inverse powers decrease, the largest value is at T_a
+    const CoeffType inv_T = 1/T_a;
+    const CoeffType max_lnT = max( abs(log(T_a)), abs(log(T_b)) );
+
+    // (1/T)'''' = 24/T^5, (lnT)'''' = -6/T^4,
+    // (lnT/T)'''' = (24 lnT - 50)/T^5, (lnT/T^2)'''' = (120 lnT - 154)/T^6
+    d4[Table::INV_T3]      = 360*pow(inv_T,7);
+    d4[Table::INV_T2]      = 120*pow(inv_T,6);
+    d4[Table::INV_T]       = 24*pow(inv_T,5);
+    d4[Table::LNT_OVER_T2] = (120*max_lnT + 154)*pow(inv_T,6);
+    d4[Table::LNT_OVER_T]  = (24*max_lnT + 50)*pow(inv_T,5);
+    d4[Table::LNT]         = 6*pow(inv_T,4);
+    d4[Table::ONE]         = 0;
+    d4[Table::T1]          = 0;
+    d4[Table::T2]          = 0;
+    d4[Table::T3]          = 0;
+    d4[Table::T4]          = 24;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::tabulate( const CoeffType& T_min,
+                                                            const CoeffType& T_max,
+                                                            unsigned int n_intervals )
+  {
+    using std::abs;
+
+    antioch_assert_greater(T_min, CoeffType(0));
+    antioch_assert_greater(T_max, T_min);
+    antioch_assert_greater(n_intervals, 0);
+    antioch_assert( _nasa_mixture.check() );
+
+    const ChemicalMixture<CoeffType>& chem_mixture = _nasa_mixture.chemical_mixture();
+    const unsigned int n_species = chem_mixture.n_species();
+
+    _n_species   = n_species;
+    _T_min       = T_min;
+    _T_max       = T_max;
+    _n_intervals = n_intervals;
+    _dT          = (T_max - T_min) / n_intervals;
+    _inv_dT      = n_intervals / (T_max - T_min);
+
+    for( unsigned int p = 0; p < N_PROPERTIES; p++ )
+      {
+        _coeffs[p].assign( n_intervals * 4 * n_species, 0 );
+        _error_bound[p] = 0;
+      }
+
+    _exact_start.assign( n_intervals + 1, 0 );
+    _exact_species.clear();
+
+    _R.resize( n_species );
+    _cp_at_200p1.resize( n_species );
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        _R[s] = chem_mixture.R(s);
+        _cp_at_200p1[s] = _nasa_mixture.cp_at_200p1(s);
+      }
+
+    // (dT)^4/384 of the Hermite error
+    const CoeffType dT2 = _dT * _dT;
+    const CoeffType error_factor = dT2 * dT2 / 384;
+
+    CoeffType m_a[Table::N_MONOMIALS], dm_a[Table::N_MONOMIALS];
+    CoeffType m_b[Table::N_MONOMIALS], dm_b[Table::N_MONOMIALS];
+    CoeffType d4[Table::N_MONOMIALS];
+    CoeffType w[Table::N_PROPERTIES][Table::N_MONOMIALS];
+
+    for( unsigned int c = 0; c < n_intervals; c++ )
+      {
+        // last cell ends exactly at T_max
+        const CoeffType T_a = T_min + c * _dT;
+        const CoeffType T_b = (c + 1 == n_intervals) ? T_max : T_min + (c + 1) * _dT;
+
+        this->monomials( T_a, m_a, dm_a );
+        this->monomials( T_b, m_b, dm_b );
+        this->monomials_d4_bound( T_a, T_b, d4 );
+
+        for( unsigned int s = 0; s < n_species; s++ )
+          {
+            const NASAFit& fit = _nasa_mixture.curve_fit(s);
+            const std::vector<CoeffType>& temp = fit.temperatures();
+
+            // discontinuities of the curve fit in the cell
+            bool exact = false;
+            for( unsigned int j = 1; j < temp.size(); j++ )
+              exact = exact || ( temp[j] >= T_a && temp[j] <= T_b );
+
+            if( exact )
+              {
+                _exact_species.push_back(s);
+                continue;
+              }
+
+            std::fill( &w[0][0], &w[0][0] + Table::N_PROPERTIES * Table::N_MONOMIALS, CoeffType(0) );
+            const unsigned int interval = fit.interval( CoeffType((T_a + T_b) / 2) );
+            AntiochPrivate::nasa_thermo_table_weights<CoeffType,NASAFit>( fit, fit.coefficients(interval), w );
+
+            for( unsigned int p = 0; p < N_PROPERTIES; p++ )
+              {
+                CoeffType f_a = 0, f_b = 0, df_a = 0, df_b = 0, f4 = 0;
+                for( unsigned int m = 0; m < Table::N_MONOMIALS; m++ )
+                  {
+                    f_a  += w[p][m] * m_a[m];
+                    f_b  += w[p][m] * m_b[m];
+                    df_a += w[p][m] * dm_a[m];
+                    df_b += w[p][m] * dm_b[m];
+                    f4   += abs(w[p][m]) * d4[m];
+                  }
+
+                // slopes in the local coordinate
+                const CoeffType d_a = (T_b - T_a) * df_a;
+                const CoeffType d_b = (T_b - T_a) * df_b;
+
+                CoeffType * coeffs = &_coeffs[p][c * 4 * n_species];
+                coeffs[s]               = f_a;
+                coeffs[n_species + s]   = d_a;
+                coeffs[2*n_species + s] = 3*(f_b - f_a) - 2*d_a - d_b;
+                coeffs[3*n_species + s] = 2*(f_a - f_b) + d_a + d_b;
+
+                _error_bound[p] = std::max( _error_bound[p], error_factor * f4 );
+              }
+          }
+
+        _exact_start[c + 1] = _exact_species.size();
+      }
+
+    _version   = _nasa_mixture.parameter_version();
+    _tabulated = true;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::tabulate_to_tolerance( const CoeffType& T_min,
+                                                                         const CoeffType& T_max,
+                                                                         const CoeffType& tolerance )
+  {
+    using std::ceil;
+    using std::pow;
+
+    antioch_assert_greater(tolerance, CoeffType(0));
+
+    // the bound scales as the fourth power of the cell width
+    unsigned int n_intervals = 16;
+    for( unsigned int iter = 0; iter < 32; iter++ )
+      {
+        this->tabulate( T_min, T_max, n_intervals );
+
+        CoeffType bound = 0;
+        for( unsigned int p = 0; p < N_PROPERTIES; p++ )
+          bound = std::max( bound, _error_bound[p] );
+
+        if( bound <= tolerance )
+          return;
+
+        const CoeffType ratio = pow( bound / tolerance, CoeffType(0.25) );
+        n_intervals = static_cast<unsigned int>( ceil( n_intervals * std::max( ratio, CoeffType(1.1) ) ) );
+      }
+
+    antioch_error_msg("The tolerance on the tabulated thermodynamics could not be reached.");
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::check_temperature( const CoeffType& T ) const
+  {
+    if( !this->is_tabulated() )
+      antioch_error_msg("The NASA mixture is not tabulated for its current parameters, tabulate() must be called.");
+
+    if( !(T >= _T_min && T <= _T_max) )
+      {
+        std::cerr << "Error: temperature " << T << " out of the tabulated range ["
+                  << _T_min << ", " << _T_max << "]" << std::endl;
+        antioch_error();
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType>
+  inline
+  StateType TabulatedNASAEvaluator<CoeffType,NASAFit>::exact_value( Property p,
+                                                                    const TempCache<StateType>& cache,
+                                                                    unsigned int s ) const
+  {
+    const NASAFit& fit = _nasa_mixture.curve_fit(s);
+
+    switch( p )
+      {
+      case CP_OVER_R:
+        return fit.cp_over_R(cache);
+      case H_OVER_RT:
+        return fit.h_over_RT(cache);
+      case S_OVER_R:
+        return fit.s_over_R(cache);
+      case H_RT_MINUS_S_R:
+        return fit.h_RT_minus_s_R(cache);
+      default:
+        antioch_error();
+      }
+
+    return 0;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::evaluate( Property p,
+                                                            const TempCache<StateType>& cache,
+                                                            VectorStateType& values ) const
+  {
+    antioch_assert_less( p, N_PROPERTIES );
+    antioch_assert_equal_to( values.size(), _n_species );
+
+    this->check_temperature( cache.T );
+
+    const unsigned int n_species = _n_species;
+
+    // cell and local coordinate
+    const StateType x = (cache.T - _T_min) * _inv_dT;
+    const unsigned int c = std::min( static_cast<unsigned int>(x), _n_intervals - 1 );
+    const StateType t = x - StateType(c);
+
+    const CoeffType * c0 = &_coeffs[p][c * 4 * n_species];
+    const CoeffType * c1 = c0 + n_species;
+    const CoeffType * c2 = c1 + n_species;
+    const CoeffType * c3 = c2 + n_species;
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      values[s] = ((c3[s]*t + c2[s])*t + c1[s])*t + c0[s];
+
+    for( unsigned int e = _exact_start[c]; e != _exact_start[c + 1]; e++ )
+      values[_exact_species[e]] = this->exact_value( p, cache, _exact_species[e] );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::cp_over_R( const TempCache<StateType>& cache,
+                                                             VectorStateType& cp_over_R ) const
+  {
+    this->evaluate( CP_OVER_R, cache, cp_over_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::h_over_RT( const TempCache<StateType>& cache,
+                                                             VectorStateType& h_over_RT ) const
+  {
+    this->evaluate( H_OVER_RT, cache, h_over_RT );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::s_over_R( const TempCache<StateType>& cache,
+                                                            VectorStateType& s_over_R ) const
+  {
+    this->evaluate( S_OVER_R, cache, s_over_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::h_RT_minus_s_R( const TempCache<StateType>& cache,
+                                                                  VectorStateType& h_RT_minus_s_R ) const
+  {
+    this->evaluate( H_RT_MINUS_S_R, cache, h_RT_minus_s_R );
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::cp( const TempCache<StateType>& cache,
+                                                      VectorStateType& cp ) const
+  {
+    antioch_assert_equal_to( cp.size(), _n_species );
+
+    // T < 200.1 ? cp_at_200p1 : R * cp_over_R
+    if( cache.T < StateType(200.1) )
+      {
+        this->check_temperature( cache.T );
+
+        for( unsigned int s = 0; s < _n_species; s++ )
+          cp[s] = _cp_at_200p1[s];
+
+        return;
+      }
+
+    this->evaluate( CP_OVER_R, cache, cp );
+
+    for( unsigned int s = 0; s < _n_species; s++ )
+      cp[s] *= _R[s];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::h( const TempCache<StateType>& cache,
+                                                     VectorStateType& h ) const
+  {
+    this->evaluate( H_OVER_RT, cache, h );
+
+    for( unsigned int s = 0; s < _n_species; s++ )
+      h[s] = _R[s]*cache.T*h[s];
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void TabulatedNASAEvaluator<CoeffType,NASAFit>::s( const TempCache<StateType>& cache,
+                                                     VectorStateType& s ) const
+  {
+    this->evaluate( S_OVER_R, cache, s );
+
+    for( unsigned int i = 0; i < _n_species; i++ )
+      s[i] *= _R[i];
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_TABULATED_NASA_EVALUATOR_H
@@ -33,6 +33,13 @@
 
 namespace Antioch
 {
+  //! Powers and log of a temperature, shared by the evaluators
+  /*!
+   * All the values are computed up front, so a const cache can be
+   * read concurrently and a single cache can feed thermo, kinetics
+   * and transport. ExtendedTempCache adds the inverse and fractional
+   * powers of T, for the few evaluators that read them.
+   */
   template<typename StateType=double>
   class TempCache
   {
@@ -46,6 +53,20 @@ namespace Antioch
               const StateType& T4_in,
               const StateType& lnT_in);
 
+    //! Copies the values cached by \p other
+    /*!
+     * T still refers to the same temperature, for the owner
+     * of the referenced temperature, once it has been copied.
+     */
+    TempCache& operator=(const TempCache& other);
+
+    //! Recomputes the powers and the log of T
+    /*!
+     * For the owner of the referenced temperature, once it
+     * has been changed.
+     */
+    void update();
+
     const StateType& T;
     StateType T2;
     StateType T3;
@@ -78,6 +99,29 @@ namespace Antioch
     return;
   }
 
+  template<typename StateType>
+  TempCache<StateType> & TempCache<StateType>::operator=(const TempCache<StateType>& other)
+  {
+    if( this == &other )
+      return *this;
+
+    T2      = other.T2;
+    T3      = other.T3;
+    T4      = other.T4;
+    lnT     = other.lnT;
+
+    return *this;
+  }
+
+  template<typename StateType>
+  void TempCache<StateType>::update()
+  {
+    T2  = T*T;
+    T3  = T2*T;
+    T4  = T2*T2;
+    lnT = ant_log(T);
+  }
+
 }
 
 #endif // ANTIOCH_TEMP_CACHE_H
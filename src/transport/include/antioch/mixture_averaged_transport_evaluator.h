@@ -429,11 +429,14 @@ namespace Antioch
   {
     const typename value_type<VectorStateType>::type M = _mixture.chem_mixture().M(mass_fractions);
 
+    // Shared by all the species viscosities
+    const ExtendedTempCache<StateType> cache(T);
+
     // Precompute needed quantities
     // chi_s = w_s*M/M_s
     for( unsigned int s = 0; s < _mixture.chem_mixture().n_species(); s++ )
       {
-        mu[s] = _viscosity(s,T);
+        mu[s] = _viscosity(s,cache);
         chi[s] = mass_fractions[s]*M/_mixture.chem_mixture().M(s);
       }
 
@@ -61,6 +61,10 @@ namespace Antioch
     template <typename StateType>
     StateType operator()( const unsigned int s, const StateType& T ) const;
 
+    //! Evaluate viscosity for species s at the cached temperature
+    template <typename StateType>
+    StateType operator()( const unsigned int s, const ExtendedTempCache<StateType>& cache ) const;
+
     //! Add species viscosity
     void add( const std::string& species_name,
 	      const std::vector<CoeffType>& coeffs );
@@ -155,6 +159,18 @@ namespace Antioch
     return (*_species_viscosities[s])(T);
   }
 
+  template<typename Viscosity, class CoeffType>
+  template<typename StateType>
+  inline
+  StateType MixtureViscosity<Viscosity,CoeffType>::operator()( const unsigned int s,
+							       const ExtendedTempCache<StateType>& cache ) const
+  {
+    antioch_assert_less_equal( s, _species_viscosities.size() );
+    antioch_assert( _species_viscosities[s] );
+
+    return (*_species_viscosities[s])(cache);
+  }
+
   template<typename Viscosity, class CoeffType>
   template <typename StateType>
   inline
@@ -29,8 +29,13 @@
 #define ANTIOCH_CMATH_H
 
 // Antioch headers
+#include "antioch_config.h"
 #include "antioch/metaprogramming_decl.h"
 
+#ifdef ANTIOCH_FAST_MATH_DIGITS
+#include "antioch/fast_math.h"
+#endif
+
 // C++ headers
 #include <algorithm> // max, min
 #include <cmath>     // everything else
@@ -118,6 +123,30 @@ ANTIOCH_BINARY_SHIM(max)
 ANTIOCH_BINARY_SHIM(min)
 ANTIOCH_BINARY_SHIM(fmod)
 
+#ifdef ANTIOCH_FAST_MATH_DIGITS
+// Opt-in fast kernels for plain floating point types; the non-template
+// overloads are preferred to the shims above.
+#define ANTIOCH_FAST_MATH_SHIM(Type) \
+  inline \
+  Type \
+  ant_exp (const Type& in) \
+  { return FastMath<ANTIOCH_FAST_MATH_DIGITS>::exp(in); } \
+ \
+  inline \
+  Type \
+  ant_log (const Type& in) \
+  { return FastMath<ANTIOCH_FAST_MATH_DIGITS>::log(in); } \
+ \
+  inline \
+  Type \
+  ant_pow (const Type& in1, const Type& in2) \
+  { return FastMath<ANTIOCH_FAST_MATH_DIGITS>::pow(in1, in2); }
+
+ANTIOCH_FAST_MATH_SHIM(float)
+ANTIOCH_FAST_MATH_SHIM(double)
+ANTIOCH_FAST_MATH_SHIM(long double)
+#endif // ANTIOCH_FAST_MATH_DIGITS
+
 } // end namespace Antioch
 
 #endif //ANTIOCH_CMATH_H
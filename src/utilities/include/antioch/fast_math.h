@@ -0,0 +1,268 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_FAST_MATH_H
+#define ANTIOCH_FAST_MATH_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+
+// C++
+#include <cmath>
+#include <limits>
+
+namespace Antioch
+{
+  //! Tables for the FastMath kernels
+  /*!
+   * exp2[j] = 2^(j/64) and log[j] = ln(1+(j-16)/64), rounded from 21
+   * digits to the floating point type T, and the coefficients of the
+   * exp and atanh series.
+   */
+  template <typename T>
+  struct FastMathTables
+  {
+    static const T exp2[64];
+
+    static const T log[49];
+
+    //! 1/i!
+    static const T inv_factorial[7];
+
+    //! 1/(2i+1)
+    static const T inv_odd[4];
+  };
+
+  //! Table/polynomial approximations of exp, log and pow
+  /*!
+   * The kernels are accurate to about 10^-Digits in relative terms
+   * (down to a few ulps when Digits exceeds the precision of the
+   * type), the degree of the polynomials being chosen at compile time
+   * from Digits:
+   *   - exp(x) = 2^(k/64) * exp(r), with |r| <= ln(2)/128, 2^(k/64)
+   *     coming from a 64 entries table and exp(r) from its Taylor
+   *     polynomial,
+   *   - log(x) = e*ln(2) + ln(c) + 2 atanh((m-c)/(m+c)), with x = m*2^e,
+   *     c = 1 + j/64 the nearest table entry to m in [3/4,3/2) and
+   *     the atanh series truncated,
+   *   - pow(x,y) = exp(y*log(x)), its relative error is amplified by
+   *     |y*log(x)|.
+   *
+   * float is evaluated in double. Non-finite, non-positive (log, pow)
+   * or out of range (exp) arguments are forwarded to the standard
+   * library.  These kernels are used by ant_exp, ant_log and ant_pow
+   * on plain floating point types when Antioch is configured
+   * --with-fast-math=Digits (ANTIOCH_FAST_MATH_DIGITS).
+   */
+  template <unsigned int Digits>
+  class FastMath
+  {
+    antioch_static_assert( Digits >= 5 && Digits <= 19,
+                           "FastMath kernels are accurate to 5 up to 19 digits" );
+
+  public:
+
+    static float exp( float x )
+    { return static_cast<float>(exp_kernel(static_cast<double>(x))); }
+
+    static double exp( double x )
+    { return exp_kernel(x); }
+
+    static long double exp( long double x )
+    { return exp_kernel(x); }
+
+    static float log( float x )
+    { return static_cast<float>(log_kernel(static_cast<double>(x))); }
+
+    static double log( double x )
+    { return log_kernel(x); }
+
+    static long double log( long double x )
+    { return log_kernel(x); }
+
+    static float pow( float x, float y )
+    { return static_cast<float>(pow_kernel(static_cast<double>(x), static_cast<double>(y))); }
+
+    static double pow( double x, double y )
+    { return pow_kernel(x,y); }
+
+    static long double pow( long double x, long double y )
+    { return pow_kernel(x,y); }
+
+  private:
+
+    //! Degree of the Taylor polynomial of exp(r) - 1, |r| <= ln(2)/128
+    static const unsigned int exp_degree = (Digits <= 7)  ? 2 :
+                                           (Digits <= 10) ? 3 :
+                                           (Digits <= 13) ? 4 :
+                                           (Digits <= 16) ? 5 : 6;
+
+    //! Number of terms of the atanh(s) series, |s| <= 1/192
+    static const unsigned int log_terms = (Digits <= 5)  ? 1 :
+                                          (Digits <= 9)  ? 2 :
+                                          (Digits <= 14) ? 3 : 4;
+
+    template <typename T>
+    static T exp_kernel( T x );
+
+    template <typename T>
+    static T log_kernel( T x );
+
+    template <typename T>
+    static T pow_kernel( T x, T y );
+
+    //! ln(2) = ln2_hi + ln2_lo, ln2_hi having 32 significant bits
+    template <typename T>
+    static T ln2_hi() { return T(0.69314718036912381649017333984375L); }
+
+    template <typename T>
+    static T ln2_lo() { return T(1.908214929270587816144e-10L); }
+  };
+
+  template <typename T>
+  const T FastMathTables<T>::exp2[64] = {
+    1.000000000000000000000L, 1.010889286051700460020L, 1.021897148654116678234L, 1.033024879021228422500L,
+    1.044273782427413840322L, 1.055645178360557158808L, 1.067140400676823618170L, 1.078760797757119793741L,
+    1.090507732665257659207L, 1.102382583307840943556L, 1.114386742595892536309L, 1.126521618608241899795L,
+    1.138788634756691653704L, 1.151189229952982705818L, 1.163724858777577513814L, 1.176396991650281276285L,
+    1.189207115002721066717L, 1.202156731452703142096L, 1.215247359980468878117L, 1.228480536106870005694L,
+    1.241857812073484048594L, 1.255380757024691089579L, 1.269050957191733222554L, 1.282870016078778280727L,
+    1.296839554651009665934L, 1.310961211524764341923L, 1.325236643159741294630L, 1.339667524053303005360L,
+    1.354255546936892728298L, 1.369002422974590611930L, 1.383909881963831954873L, 1.398979672538311140210L,
+    1.414213562373095048802L, 1.429613338391970011235L, 1.445180806977046620037L, 1.460917794180646988651L,
+    1.476826145939499311387L, 1.492907728291264849201L, 1.509164427593422739766L, 1.525598150744538306851L,
+    1.542210825407940823612L, 1.559004400237836967034L, 1.575980845107886486455L, 1.593142151342266897937L,
+    1.610490331949254308180L, 1.628027421857347766848L, 1.645755478153964844519L, 1.663676580326736435046L,
+    1.681792830507429086062L, 1.700106353718523469501L, 1.718619298122477915629L, 1.737333835273706248994L,
+    1.756252160373299483112L, 1.775376492526521252551L, 1.794709075003107186428L, 1.814252175500398756250L,
+    1.834008086409342463487L, 1.853979125083385568392L, 1.874167634110299901330L, 1.894575981586965641340L,
+    1.915206561397147293873L, 1.936061793492294450598L, 1.957144124175400269018L, 1.978456026387950968258L
+  };
+
+  template <typename T>
+  const T FastMathTables<T>::log[49] = {
+    -2.876820724517809274392e-1L, -2.670627852490452462927e-1L, -2.468600779315257978846e-1L, -2.270574506353460848586e-1L,
+    -2.076393647782445016154e-1L, -1.885911698075500223589e-1L, -1.698990367953974729004e-1L, -1.515498981272009378407e-1L,
+    -1.335313926245226231463e-1L, -1.158318155251217050991e-1L, -9.844007281325251990289e-2L, -8.134563945395240588734e-2L,
+    -6.453852113757117167292e-2L, -4.800921918636060775200e-2L, -3.174869831458030115700e-2L, -1.574835696813916860755e-2L,
+    0.L, 1.550418653596525415085e-2L, 3.077165866675368837103e-2L, 4.580953603129420316668e-2L,
+    6.062462181643484258061e-2L, 7.522342123758752569861e-2L, 8.961215868968713261995e-2L, 1.037967936816435648261e-1L,
+    1.177830356563834545388e-1L, 1.315763577887192725887e-1L, 1.451820098444978972819e-1L, 1.586050301766385840934e-1L,
+    1.718502569266592223401e-1L, 1.849223384940119926639e-1L, 1.978257433299198803626e-1L, 2.105647691073496376696e-1L,
+    2.231435513142097557663e-1L, 2.355660713127669090776e-1L, 2.478361639045812567806e-1L, 2.599575244369260669721e-1L,
+    2.719337154836417588317e-1L, 2.837681731306445983469e-1L, 2.954642128938358763867e-1L, 3.070250352949118620751e-1L,
+    3.184537311185346158102e-1L, 3.297532863724679818144e-1L, 3.409265869705932103051e-1L, 3.519764231571781846554e-1L,
+    3.629054936893684531378e-1L, 3.737164097935840808210e-1L, 3.844116989103320397348e-1L, 3.949938082408689781064e-1L,
+    4.054651081081643819780e-1L
+  };
+
+  template <typename T>
+  const T FastMathTables<T>::inv_factorial[7] = {
+    1.L, 1.L, 0.5L, 1.666666666666666666667e-1L, 4.166666666666666666667e-2L,
+    8.333333333333333333333e-3L, 1.388888888888888888889e-3L
+  };
+
+  template <typename T>
+  const T FastMathTables<T>::inv_odd[4] = {
+    1.L, 3.333333333333333333333e-1L, 0.2L, 1.428571428571428571429e-1L
+  };
+
+  template <unsigned int Digits>
+  template <typename T>
+  inline
+  T FastMath<Digits>::exp_kernel( T x )
+  {
+    // NaN, infinities and overflow/underflow, beyond the range of any
+    // type, are left to the library; this also keeps k*ln2_hi exact
+    if( !(std::abs(x) < T(11000)) )
+      return std::exp(x);
+
+    // x = k*ln(2)/64 + r
+    const T n = std::floor(x * T(92.332482616893656877L) + T(0.5L)); // 64/ln(2)
+    const long k = static_cast<long>(n);
+    const T r = (x - n*(ln2_hi<T>()/64)) - n*(ln2_lo<T>()/64);
+
+    // exp(r) - 1 = r*(1 + r*(1/2 + r*(1/6 + ...)))
+    T p = FastMathTables<T>::inv_factorial[exp_degree];
+    for(unsigned int i = exp_degree - 1; i > 0; i--)
+      p = FastMathTables<T>::inv_factorial[i] + p*r;
+    p *= r;
+
+    const long j = k & 63;
+    const T t = FastMathTables<T>::exp2[j];
+
+    return std::ldexp(t + t*p, static_cast<int>((k - j)/64));
+  }
+
+  template <unsigned int Digits>
+  template <typename T>
+  inline
+  T FastMath<Digits>::log_kernel( T x )
+  {
+    // zero, negative, infinite and NaN arguments are left to the library
+    if( !(x > 0) || x > std::numeric_limits<T>::max() )
+      return std::log(x);
+
+    // x = m*2^e, m in [3/4,3/2) so that e = 0 around x = 1 and
+    // e*ln(2) never cancels with ln(c)
+    int e;
+    T m = std::frexp(x,&e);
+    if( m < T(0.75L) )
+      {
+        m *= T(2);
+        e--;
+      }
+
+    // nearest table entry, |m - c| <= 1/128
+    const int j = static_cast<int>(std::floor((m - T(1))*T(64) + T(0.5L)));
+    const T c = T(1) + T(j)/T(64);
+
+    // ln(m/c) = 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...)
+    const T s = (m - c)/(m + c);
+    const T s2 = s*s;
+    T p = FastMathTables<T>::inv_odd[log_terms - 1];
+    for(unsigned int i = log_terms - 1; i > 0; i--)
+      p = FastMathTables<T>::inv_odd[i - 1] + p*s2;
+    const T log_m_c = T(2)*s*p;
+
+    const T E = T(e);
+    return (E*ln2_hi<T>() + FastMathTables<T>::log[j+16]) + (E*ln2_lo<T>() + log_m_c);
+  }
+
+  template <unsigned int Digits>
+  template <typename T>
+  inline
+  T FastMath<Digits>::pow_kernel( T x, T y )
+  {
+    if( !(x > 0) || x > std::numeric_limits<T>::max() || y != y )
+      return std::pow(x,y);
+
+    return exp_kernel(y * log_kernel(x));
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_FAST_MATH_H
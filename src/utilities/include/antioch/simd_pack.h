@@ -0,0 +1,321 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_SIMD_PACK_H
+#define ANTIOCH_SIMD_PACK_H
+
+// C++
+#include <cmath>
+#include <cstddef> // std::size_t
+#include <iostream>
+
+namespace Antioch
+{
+  //! Fixed-width pack of N values, evaluated lane by lane.
+  /*!
+   * SIMDPack is a self-contained StateType for evaluating N cells per
+   * call without any external library.  The storage is a plain array
+   * and every operation is a loop with a compile-time trip count, so
+   * that the compiler keeps small packs in (vector) registers and
+   * vectorizes the loops; unlike std::valarray or std::vector, no
+   * operation ever allocates.
+   *
+   * Comparisons return a SIMDPack<bool,N> mask, to be used with
+   * Antioch::if_else().  The shims making SIMDPack a StateType are
+   * in simd_pack_utils_decl.h and simd_pack_utils.h.
+   */
+  template <typename T, std::size_t N>
+  class SIMDPack
+  {
+  public:
+
+    typedef T value_type;
+
+    //! Uninitialized pack
+    SIMDPack(){}
+
+    //! Broadcasts \p value to all the lanes
+    SIMDPack( const T& value )
+    {
+      for(std::size_t i = 0; i < N; i++)
+        _data[i] = value;
+    }
+
+    //! Lane by lane conversion from another value type
+    template <typename T2>
+    explicit SIMDPack( const SIMDPack<T2,N>& other )
+    {
+      for(std::size_t i = 0; i < N; i++)
+        _data[i] = static_cast<T>(other[i]);
+    }
+
+    static std::size_t size() { return N; }
+
+    T& operator[]( std::size_t i ) { return _data[i]; }
+
+    const T& operator[]( std::size_t i ) const { return _data[i]; }
+
+#define ANTIOCH_SIMD_PACK_COMPOUND(op) \
+    SIMDPack& operator op ( const SIMDPack& other ) \
+    { \
+      for(std::size_t i = 0; i < N; i++) \
+        _data[i] op other._data[i]; \
+      return *this; \
+    } \
+ \
+    SIMDPack& operator op ( const T& value ) \
+    { \
+      for(std::size_t i = 0; i < N; i++) \
+        _data[i] op value; \
+      return *this; \
+    }
+
+    ANTIOCH_SIMD_PACK_COMPOUND(+=)
+    ANTIOCH_SIMD_PACK_COMPOUND(-=)
+    ANTIOCH_SIMD_PACK_COMPOUND(*=)
+    ANTIOCH_SIMD_PACK_COMPOUND(/=)
+
+#undef ANTIOCH_SIMD_PACK_COMPOUND
+
+    SIMDPack operator-() const
+    {
+      SIMDPack returnval;
+      for(std::size_t i = 0; i < N; i++)
+        returnval._data[i] = -_data[i];
+      return returnval;
+    }
+
+    SIMDPack operator!() const
+    {
+      SIMDPack returnval;
+      for(std::size_t i = 0; i < N; i++)
+        returnval._data[i] = !_data[i];
+      return returnval;
+    }
+
+  private:
+
+    T _data[N];
+  };
+
+  // Lane by lane arithmetic, the scalar operand is not deduced so that
+  // literals and other arithmetic types convert to the value type.
+
+#define ANTIOCH_SIMD_PACK_ARITHMETIC(op) \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> operator op ( const SIMDPack<T,N>& a, const SIMDPack<T,N>& b ) \
+  { \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a[i] op b[i]; \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> operator op ( const SIMDPack<T,N>& a, const typename SIMDPack<T,N>::value_type& b ) \
+  { \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a[i] op b; \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> operator op ( const typename SIMDPack<T,N>::value_type& a, const SIMDPack<T,N>& b ) \
+  { \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a op b[i]; \
+    return returnval; \
+  }
+
+  ANTIOCH_SIMD_PACK_ARITHMETIC(+)
+  ANTIOCH_SIMD_PACK_ARITHMETIC(-)
+  ANTIOCH_SIMD_PACK_ARITHMETIC(*)
+  ANTIOCH_SIMD_PACK_ARITHMETIC(/)
+
+#undef ANTIOCH_SIMD_PACK_ARITHMETIC
+
+  // Lane by lane comparisons and logic, returning masks
+
+#define ANTIOCH_SIMD_PACK_COMPARISON(op) \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<bool,N> operator op ( const SIMDPack<T,N>& a, const SIMDPack<T,N>& b ) \
+  { \
+    SIMDPack<bool,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a[i] op b[i]; \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<bool,N> operator op ( const SIMDPack<T,N>& a, const typename SIMDPack<T,N>::value_type& b ) \
+  { \
+    SIMDPack<bool,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a[i] op b; \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<bool,N> operator op ( const typename SIMDPack<T,N>::value_type& a, const SIMDPack<T,N>& b ) \
+  { \
+    SIMDPack<bool,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = a op b[i]; \
+    return returnval; \
+  }
+
+  ANTIOCH_SIMD_PACK_COMPARISON(<)
+  ANTIOCH_SIMD_PACK_COMPARISON(<=)
+  ANTIOCH_SIMD_PACK_COMPARISON(>)
+  ANTIOCH_SIMD_PACK_COMPARISON(>=)
+  ANTIOCH_SIMD_PACK_COMPARISON(==)
+  ANTIOCH_SIMD_PACK_COMPARISON(!=)
+  ANTIOCH_SIMD_PACK_COMPARISON(&&)
+  ANTIOCH_SIMD_PACK_COMPARISON(||)
+
+#undef ANTIOCH_SIMD_PACK_COMPARISON
+
+  // Math functions, found by argument-dependent lookup from the
+  // Antioch::ant_* shims and from "using std::exp; exp(x)" idioms.
+
+#define ANTIOCH_SIMD_PACK_UNARY(funcname) \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> funcname ( const SIMDPack<T,N>& in ) \
+  { \
+    using std::funcname; \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = funcname(in[i]); \
+    return returnval; \
+  }
+
+  ANTIOCH_SIMD_PACK_UNARY(exp)
+  ANTIOCH_SIMD_PACK_UNARY(log)
+  ANTIOCH_SIMD_PACK_UNARY(log10)
+  ANTIOCH_SIMD_PACK_UNARY(sin)
+  ANTIOCH_SIMD_PACK_UNARY(cos)
+  ANTIOCH_SIMD_PACK_UNARY(tan)
+  ANTIOCH_SIMD_PACK_UNARY(asin)
+  ANTIOCH_SIMD_PACK_UNARY(acos)
+  ANTIOCH_SIMD_PACK_UNARY(atan)
+  ANTIOCH_SIMD_PACK_UNARY(sinh)
+  ANTIOCH_SIMD_PACK_UNARY(cosh)
+  ANTIOCH_SIMD_PACK_UNARY(tanh)
+  ANTIOCH_SIMD_PACK_UNARY(sqrt)
+  ANTIOCH_SIMD_PACK_UNARY(abs)
+  ANTIOCH_SIMD_PACK_UNARY(fabs)
+  ANTIOCH_SIMD_PACK_UNARY(ceil)
+  ANTIOCH_SIMD_PACK_UNARY(floor)
+
+#undef ANTIOCH_SIMD_PACK_UNARY
+
+#define ANTIOCH_SIMD_PACK_BINARY(funcname) \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> funcname ( const SIMDPack<T,N>& a, const SIMDPack<T,N>& b ) \
+  { \
+    using std::funcname; \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = funcname(a[i], b[i]); \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> funcname ( const SIMDPack<T,N>& a, const typename SIMDPack<T,N>::value_type& b ) \
+  { \
+    using std::funcname; \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = funcname(a[i], b); \
+    return returnval; \
+  } \
+ \
+  template <typename T, std::size_t N> \
+  inline \
+  SIMDPack<T,N> funcname ( const typename SIMDPack<T,N>::value_type& a, const SIMDPack<T,N>& b ) \
+  { \
+    using std::funcname; \
+    SIMDPack<T,N> returnval; \
+    for(std::size_t i = 0; i < N; i++) \
+      returnval[i] = funcname(a, b[i]); \
+    return returnval; \
+  }
+
+  ANTIOCH_SIMD_PACK_BINARY(pow)
+  ANTIOCH_SIMD_PACK_BINARY(atan2)
+  ANTIOCH_SIMD_PACK_BINARY(fmod)
+
+#undef ANTIOCH_SIMD_PACK_BINARY
+
+  //! Lane by lane maximum
+  template <typename T, std::size_t N>
+  inline
+  SIMDPack<T,N> max( const SIMDPack<T,N>& a, const SIMDPack<T,N>& b )
+  {
+    SIMDPack<T,N> returnval;
+    for(std::size_t i = 0; i < N; i++)
+      returnval[i] = (a[i] < b[i]) ? b[i] : a[i];
+    return returnval;
+  }
+
+  //! Lane by lane minimum
+  template <typename T, std::size_t N>
+  inline
+  SIMDPack<T,N> min( const SIMDPack<T,N>& a, const SIMDPack<T,N>& b )
+  {
+    SIMDPack<T,N> returnval;
+    for(std::size_t i = 0; i < N; i++)
+      returnval[i] = (b[i] < a[i]) ? b[i] : a[i];
+    return returnval;
+  }
+
+  template <typename T, std::size_t N>
+  inline
+  std::ostream& operator<<( std::ostream& output, const SIMDPack<T,N>& a )
+  {
+    output << '{';
+    if (N)
+      output << a[0];
+    for (std::size_t i=1; i<N; ++i)
+      output << ',' << a[i];
+    output << '}';
+    return output;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_SIMD_PACK_H
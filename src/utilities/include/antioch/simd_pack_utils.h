@@ -0,0 +1,178 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_SIMD_PACK_UTILS_H
+#define ANTIOCH_SIMD_PACK_UTILS_H
+
+#ifdef ANTIOCH_METAPROGRAMMING_H
+#  ifndef ANTIOCH_SIMD_PACK_UTILS_DECL_H
+#    error simd_pack_utils_decl.h must be included before metaprogramming.h
+#  endif
+#endif
+
+// Antioch
+#include "antioch/metaprogramming.h"
+#include "antioch/simd_pack.h"
+
+// C++
+#include <cmath>
+#include <cstddef> // std::size_t
+
+namespace Antioch
+{
+
+template <typename T, std::size_t N>
+inline
+T
+max (const SIMDPack<T,N>& in)
+{
+  T maxval = in[0];
+  for (std::size_t i = 1; i < N; ++i)
+    maxval = (maxval < in[i]) ? in[i] : maxval;
+
+  return maxval;
+}
+
+template <typename T, std::size_t N>
+inline
+T
+min (const SIMDPack<T,N>& in)
+{
+  T minval = in[0];
+  for (std::size_t i = 1; i < N; ++i)
+    minval = (in[i] < minval) ? in[i] : minval;
+
+  return minval;
+}
+
+template <typename T, std::size_t N>
+inline
+bool
+has_nan (const SIMDPack<T,N>& in)
+{
+  using std::isnan;
+
+  for (std::size_t i = 0; i < N; ++i)
+    if (isnan(in[i]))
+      return true;
+
+  return false;
+}
+
+template <typename T, std::size_t N>
+struct has_size<SIMDPack<T,N> >
+{
+  static const bool value = true;
+};
+
+template <typename T, std::size_t N>
+struct return_auto<SIMDPack<T,N> >
+{
+  static const bool value = false;
+};
+
+template <typename T, std::size_t N>
+struct size_type<SIMDPack<T,N> >
+{
+  typedef std::size_t type;
+};
+
+template <typename T, std::size_t N>
+struct value_type<SIMDPack<T,N> >
+{
+  typedef T type;
+};
+
+template <typename T, std::size_t N>
+struct raw_value_type<SIMDPack<T,N> >
+{
+  typedef typename raw_value_type<T>::type type;
+};
+
+template <typename T, std::size_t N>
+inline
+SIMDPack<T,N>
+zero_clone(const SIMDPack<T,N>& /* example */)
+{
+  return SIMDPack<T,N>(T(0));
+}
+
+template <typename T1, typename T2, std::size_t N>
+inline
+void
+zero_clone(SIMDPack<T1,N>& output, const SIMDPack<T2,N>& /* example */)
+{
+  output = SIMDPack<T1,N>(T1(0));
+}
+
+template <typename T, std::size_t N, typename Scalar>
+inline
+SIMDPack<T,N>
+constant_clone(const SIMDPack<T,N>& /* example */, const Scalar& value)
+{
+  return SIMDPack<T,N>(static_cast<T>(value));
+}
+
+template <typename T, std::size_t N>
+inline
+void
+init_clone(SIMDPack<T,N>& output, const SIMDPack<T,N>& example)
+{
+  output = example;
+}
+
+template <typename T, std::size_t N>
+inline
+SIMDPack<T,N>
+if_else(const SIMDPack<bool,N>& condition,
+        const SIMDPack<T,N>& if_true,
+        const SIMDPack<T,N>& if_false)
+{
+  SIMDPack<T,N> returnval;
+
+  for (std::size_t i=0; i != N; ++i)
+    returnval[i] = condition[i] ? if_true[i] : if_false[i];
+
+  return returnval;
+}
+
+template <typename VectorT, std::size_t N>
+inline
+typename Antioch::enable_if_c<
+        Antioch::is_simd_pack<typename value_type<VectorT>::type>::value,
+        typename value_type<VectorT>::type
+>::type
+eval_index(const VectorT& vec, const SIMDPack<unsigned int,N>& index)
+{
+  typename value_type<VectorT>::type returnval;
+  for (std::size_t i=0; i != N; ++i)
+    returnval[i] = vec[index[i]][i];
+  return returnval;
+}
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_SIMD_PACK_UTILS_H
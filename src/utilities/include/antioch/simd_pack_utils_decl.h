@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_SIMD_PACK_UTILS_DECL_H
+#define ANTIOCH_SIMD_PACK_UTILS_DECL_H
+
+#ifdef ANTIOCH_METAPROGRAMMING_H
+#  error simd_pack_utils_decl.h must be included before metaprogramming.h
+#endif
+
+// Antioch
+#include "antioch/metaprogramming_decl.h"
+#include "antioch/simd_pack.h"
+
+// C++
+#include <cstddef> // std::size_t
+
+namespace Antioch
+{
+
+template <typename T>
+struct is_simd_pack {
+  static const bool value = false;
+};
+
+template <typename T, std::size_t N>
+struct is_simd_pack<SIMDPack<T,N> > {
+  static const bool value = true;
+};
+
+// Class to allow tag dispatching to SIMDPack specializations
+struct simd_pack_library_tag : public numeric_library_tag {};
+
+// SIMDPack has no expression templates; all types store state
+template <typename T>
+struct state_type<T, typename enable_if_c<is_simd_pack<T>::value,void>::type> {
+  typedef T type;
+};
+
+template <typename T, std::size_t N, typename NewScalar>
+struct rebind<SIMDPack<T,N>, NewScalar>
+{
+  typedef SIMDPack<NewScalar,N> type;
+};
+
+template <typename T, std::size_t N>
+inline
+T
+max (const SIMDPack<T,N>& in);
+
+template <typename T, std::size_t N>
+inline
+T
+min (const SIMDPack<T,N>& in);
+
+template <typename T, std::size_t N>
+inline
+bool
+has_nan (const SIMDPack<T,N>& in);
+
+template <typename T, std::size_t N>
+struct has_size<SIMDPack<T,N> >;
+
+template <typename T, std::size_t N>
+struct return_auto<SIMDPack<T,N> >;
+
+template <typename T, std::size_t N>
+struct size_type<SIMDPack<T,N> >;
+
+template <typename T, std::size_t N>
+struct value_type<SIMDPack<T,N> >;
+
+template <typename T, std::size_t N>
+struct raw_value_type<SIMDPack<T,N> >;
+
+template <typename T, std::size_t N>
+inline
+SIMDPack<T,N>
+zero_clone(const SIMDPack<T,N>& example);
+
+template <typename T1, typename T2, std::size_t N>
+inline
+void
+zero_clone(SIMDPack<T1,N>& output, const SIMDPack<T2,N>& example);
+
+template <typename T, std::size_t N, typename Scalar>
+inline
+SIMDPack<T,N>
+constant_clone(const SIMDPack<T,N>& example, const Scalar& value);
+
+template <typename T, std::size_t N>
+inline
+void
+init_clone(SIMDPack<T,N>& output, const SIMDPack<T,N>& example);
+
+template <typename T, std::size_t N>
+inline
+SIMDPack<T,N>
+if_else(const SIMDPack<bool,N>& condition,
+        const SIMDPack<T,N>& if_true,
+        const SIMDPack<T,N>& if_false);
+
+template <typename VectorT, std::size_t N>
+inline
+typename Antioch::enable_if_c<
+        Antioch::is_simd_pack<typename value_type<VectorT>::type>::value,
+        typename value_type<VectorT>::type
+>::type
+eval_index(const VectorT& vec, const SIMDPack<unsigned int,N>& index);
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_SIMD_PACK_UTILS_DECL_H
@@ -64,6 +64,9 @@ namespace Antioch
     template <typename StateType>
     StateType op_impl( const StateType& T ) const;
 
+    template <typename StateType>
+    StateType op_impl( const ExtendedTempCache<StateType>& cache ) const;
+
     void reset_coeffs_impl( const std::vector<CoeffType> coeffs );
 
     void print_impl(std::ostream& os) const;
@@ -130,6 +133,17 @@ namespace Antioch
     return zero_point_one*exp( (_a*logT + _b)*logT + _c );
   }
 
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  StateType BlottnerViscosity<CoeffType>::op_impl( const ExtendedTempCache<StateType>& cache ) const
+  {
+    using std::exp;
+    const CoeffType zero_point_one = 0.1L;
+
+    return zero_point_one*exp( (_a*cache.lnT + _b)*cache.lnT + _c );
+  }
+
   template<typename CoeffType>
   inline
   void BlottnerViscosity<CoeffType>::reset_coeffs( const CoeffType a,
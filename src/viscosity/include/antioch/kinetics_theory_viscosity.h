@@ -162,6 +162,12 @@ namespace Antioch
       op_impl(const StateType &T) const
       ANTIOCH_AUTOFUNC(StateType,  this->viscosity(T)  )
 
+      //! sqrt(T) is part of the interpolated collision integral, only T is used
+      template <typename StateType>
+      ANTIOCH_AUTO(StateType)
+      op_impl(const ExtendedTempCache<StateType> &cache) const
+      ANTIOCH_AUTOFUNC(StateType,  this->viscosity(cache.T)  )
+
       void reset_coeffs_impl( const std::vector<CoeffType>& coeffs );
 
       void print_impl(std::ostream& os) const;
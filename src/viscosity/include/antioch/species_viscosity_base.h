@@ -27,6 +27,9 @@
 #ifndef ANTIOCH_SPECIES_VISCOSITY_BASE_H
 #define ANTIOCH_SPECIES_VISCOSITY_BASE_H
 
+// Antioch
+#include "antioch/extended_temp_cache.h"
+
 // C++
 #include <vector>
 #include <ostream>
@@ -38,7 +41,8 @@ namespace Antioch
       the interface that subclasses must adhere in order to
       ulimately be used in the MixtureViscosity class. Subclasses
       must implement:
-         -# op_impl --- this should implement operator()
+         -# op_impl --- this should implement operator(), for a temperature
+            and for an ExtendedTempCache
          -# reset_coeffs_impl --- should implement reset_coeffs
          -# print_impl --- should implement print
   */
@@ -55,6 +59,14 @@ namespace Antioch
     template <typename StateType>
     StateType operator()( const StateType& T ) const;
 
+    //! Evaluates viscosity at the cached temperature
+    /*!
+     * Subclasses use the powers and log of T in \p cache
+     * instead of recomputing them.
+     */
+    template <typename StateType>
+    StateType operator()( const ExtendedTempCache<StateType>& cache ) const;
+
     //! Extrapolate to input maximum temperature, given in [K]
     /*!
      * Some species viscosity models, e.g. KineticsTheoryViscosity, use interpolated
@@ -91,6 +103,14 @@ namespace Antioch
     return static_cast<const Subclass*>(this)->op_impl(T);
   }
 
+  template<typename Subclass, typename CoeffType>
+  template <typename StateType>
+  inline
+  StateType SpeciesViscosityBase<Subclass,CoeffType>::operator()( const ExtendedTempCache<StateType>& cache ) const
+  {
+    return static_cast<const Subclass*>(this)->op_impl(cache);
+  }
+
   template<typename Subclass, typename CoeffType>
   template <typename StateType>
   inline
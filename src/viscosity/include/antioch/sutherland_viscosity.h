@@ -72,6 +72,11 @@ namespace Antioch
     op_impl( StateType& T ) const
     ANTIOCH_AUTOFUNC(StateType, _mu_ref*ant_pow(T,CoeffType(1.5))/(T+_T_ref))
 
+    template <typename StateType>
+    ANTIOCH_AUTO(StateType)
+    op_impl( const ExtendedTempCache<StateType>& cache ) const
+    ANTIOCH_AUTOFUNC(StateType, _mu_ref*cache.T_1p5()/(cache.T+_T_ref))
+
     void reset_coeffs_impl( const std::vector<CoeffType>& coeffs );
 
     void print_impl(std::ostream& os) const;